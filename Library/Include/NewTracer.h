@@ -14,16 +14,7 @@ namespace NewTracer {
             const char* f = nullptr, int l = 0) noexcept
             : ptr(p), size(s), file(f), line(l) {
         }
-
-        Info& operator=(const Info& other) noexcept {
-            if (this != &other) {
-                ptr = other.ptr;
-                size = other.size;
-                file = other.file;
-                line = other.line;
-            }
-            return *this;
-        }
+        // No user-defined copy: Info stays trivially copyable, so _records grows with realloc.
 
         inline bool operator==(const Info& other) const noexcept {
             return ptr == other.ptr;
@@ -1,7 +1,7 @@
 #pragma once 
 
 // Profiler.h 
-#include "cstr_hash_map.h"
+#include "dense_cstr_hash_map.h"
 
 namespace Win {
 namespace Profiler {
@@ -37,7 +37,7 @@ namespace Profiler {
 		~Manager() noexcept = default;
 		LARGE_INTEGER _frequency = { 0 }; // _frequency.QuadPart gives counts per second
 		DWORD _thread_id = 0; 
-		cstr_hash_map<std::vector<Record>> _records; 
+		dense_cstr_hash_map<std::vector<Record>> _records; // report loops scan the entry array, not the buckets 
 
 	public:
 		Manager(const Manager&) = delete;
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <vector>
+#include "WinMutex.h"
+
+// concurrent_cstr_hash_map.h
+
+// Process-wide epoch based reclamation for lock-free readers.
+// A reader publishes the global epoch in its own cache-line sized slot while it walks a chain.
+// A writer retires unlinked memory tagged with the epoch of the unlink,
+// and frees it once every active reader slot has moved past that epoch.
+class epoch_domain {
+public:
+	static constexpr size_t MAX_THREADS = 256;
+	static constexpr uint64_t QUIESCENT = 0;
+
+private:
+	struct alignas(64) Slot {
+		std::atomic<uint64_t> epoch;
+		std::atomic<bool> in_use;
+	};
+
+	struct ThreadSlot {
+		Slot* slot = nullptr;
+		int depth = 0; // nested guards on the same thread
+		~ThreadSlot() noexcept {
+			if (slot) {
+				slot->epoch.store(QUIESCENT);
+				slot->in_use.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	alignas(64) std::atomic<uint64_t> _global_epoch;
+	Slot _slots[MAX_THREADS];
+
+	epoch_domain() noexcept : _global_epoch(1) {
+		for (size_t i = 0; i < MAX_THREADS; ++i) {
+			_slots[i].epoch.store(QUIESCENT, std::memory_order_relaxed);
+			_slots[i].in_use.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	// A slot is held until its thread exits, so waiting for one to free up can hang forever.
+	// More than MAX_THREADS live reader threads is a usage error: fail loudly instead.
+	Slot* acquire_slot() noexcept {
+		for (size_t i = 0; i < MAX_THREADS; ++i) {
+			if (_slots[i].in_use.load(std::memory_order_relaxed)) continue;
+			bool expected = false;
+			if (_slots[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				return &_slots[i];
+			}
+		}
+		std::terminate();
+	}
+
+	ThreadSlot& thread_slot() noexcept {
+		thread_local ThreadSlot ts;
+		if (!ts.slot) ts.slot = acquire_slot();
+		return ts;
+	}
+
+public:
+	epoch_domain(const epoch_domain&) = delete;
+	epoch_domain& operator=(const epoch_domain&) = delete;
+
+	inline static epoch_domain& GetInstance() noexcept {
+		static epoch_domain instance;
+		return instance;
+	}
+
+	class guard {
+	private:
+		ThreadSlot& _ts;
+	public:
+		explicit guard(epoch_domain& domain) noexcept : _ts(domain.thread_slot()) {
+			if (_ts.depth++ == 0) {
+				// the fence orders the slot store before any shared pointer load (pairs with min_active)
+				_ts.slot->epoch.store(domain._global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+		~guard() noexcept {
+			if (--_ts.depth == 0) _ts.slot->epoch.store(QUIESCENT, std::memory_order_release);
+		}
+		guard(const guard&) = delete;
+		guard& operator=(const guard&) = delete;
+	};
+
+	inline uint64_t current() const noexcept { return _global_epoch.load(); }
+	inline uint64_t advance() noexcept { return _global_epoch.fetch_add(1) + 1; }
+
+	// Oldest epoch some reader may still be inside. Everything retired before it is safe to free.
+	uint64_t min_active() const noexcept {
+		std::atomic_thread_fence(std::memory_order_seq_cst); // unlinks before this scan are visible to new readers
+		uint64_t min_epoch = _global_epoch.load();
+		for (size_t i = 0; i < MAX_THREADS; ++i) {
+			uint64_t e = _slots[i].epoch.load();
+			if (e != QUIESCENT && e < min_epoch) min_epoch = e;
+		}
+		return min_epoch;
+	}
+};
+
+// Sharded hash map with C-style string keys.
+// Writers lock one shard (Win::Mutex), readers take no lock at all.
+template<typename V, size_t SHARD_BITS = 6>
+class concurrent_cstr_hash_map {
+private:
+	static constexpr size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+	static constexpr float LOAD_FACTOR = 0.75f;
+	static constexpr size_t RECLAIM_THRESHOLD = 64; // retired entries per shard before a reclaim pass
+
+	// Published nodes are immutable: assigning a key swaps in a new node and retires the old one.
+	struct Node {
+		const char* key;
+		uint64_t hash;
+		V value;
+		std::atomic<Node*> next;
+		Node(const char* k, uint64_t h, const V& v, Node* n) noexcept : key(k), hash(h), value(v), next(n) {}
+	};
+
+	struct Table {
+		size_t mask;
+		std::atomic<Node*>* bucket;
+		explicit Table(size_t capacity) noexcept
+			: mask(capacity - 1), bucket(new std::atomic<Node*>[capacity]()) {}
+		~Table() noexcept { delete[] bucket; }
+	};
+
+	struct Retired {
+		void* ptr;
+		void (*destroy)(void*);
+		uint64_t epoch;
+	};
+
+	// Aligned so two shards never share a cache line under writer traffic (new Shard[] honours it in C++17)
+	struct alignas(64) Shard {
+		Win::Mutex lock;
+		std::atomic<Table*> table;
+		size_t size;
+		std::vector<Retired> retired;
+	};
+
+	Shard* _shards;
+	epoch_domain& _epoch;
+
+private:
+
+	inline static uint64_t hash_func(const char* key) noexcept {
+		uint64_t hash = 5381;
+		while (*key) {
+			hash = ((hash << 5) + hash) + static_cast<unsigned char>(*key++);
+		}
+		// djb2 leaves the top bits empty for short keys; finalize so shard bits are usable
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	inline static bool cstr_eq(const char* a, const char* b) noexcept {
+		return a == b || strcmp(a, b) == 0;
+	}
+
+	inline Shard& shard_of(uint64_t hash) const noexcept {
+		return _shards[static_cast<size_t>(hash >> (64 - SHARD_BITS))];
+	}
+
+	inline static std::atomic<Node*>& bucket_of(const Table* table, uint64_t hash) noexcept {
+		return table->bucket[static_cast<size_t>(hash) & table->mask];
+	}
+
+	static void destroy_node(void* p) noexcept { delete static_cast<Node*>(p); }
+
+	// A retired table takes its chains with it: one retired entry instead of one per node.
+	static void destroy_table(void* p) noexcept {
+		Table* table = static_cast<Table*>(p);
+		for (size_t i = 0; i <= table->mask; ++i) {
+			Node* node = table->bucket[i].load(std::memory_order_relaxed);
+			while (node) {
+				Node* next = node->next.load(std::memory_order_relaxed);
+				delete node;
+				node = next;
+			}
+		}
+		delete table;
+	}
+
+	// The fence orders the caller's unlink before the epoch read (pairs with the guard's fence):
+	// a reader that still loaded the old pointer published its epoch no later than the tag read here.
+	void retire(Shard& shard, void* ptr, void (*destroy)(void*)) noexcept {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		shard.retired.push_back(Retired{ ptr, destroy, _epoch.current() });
+		if (shard.retired.size() >= RECLAIM_THRESHOLD) reclaim(shard);
+	}
+
+	void reclaim(Shard& shard) noexcept {
+		_epoch.advance();
+		const uint64_t safe = _epoch.min_active();
+		size_t kept = 0;
+		for (size_t i = 0; i < shard.retired.size(); ++i) {
+			Retired& r = shard.retired[i];
+			if (r.epoch < safe) r.destroy(r.ptr);
+			else shard.retired[kept++] = r;
+		}
+		shard.retired.resize(kept);
+	}
+
+	// Called under the shard lock. Readers may still walk the old table,
+	// so nodes are cloned into the new table instead of being relinked.
+	// The old table is retired together with its chains only after the new table is published.
+	void grow(Shard& shard) noexcept {
+		Table* old_table = shard.table.load(std::memory_order_relaxed);
+		Table* new_table = new Table((old_table->mask + 1) * 2);
+		for (size_t i = 0; i <= old_table->mask; ++i) {
+			for (Node* node = old_table->bucket[i].load(std::memory_order_relaxed); node;
+				node = node->next.load(std::memory_order_relaxed)) {
+				std::atomic<Node*>& slot = bucket_of(new_table, node->hash);
+				slot.store(new Node(node->key, node->hash, node->value, slot.load(std::memory_order_relaxed)),
+					std::memory_order_relaxed);
+			}
+		}
+		shard.table.store(new_table, std::memory_order_release);
+		retire(shard, old_table, &destroy_table);
+	}
+
+public:
+	explicit concurrent_cstr_hash_map(size_t capacity = 1024) noexcept
+		: _shards(new Shard[SHARD_COUNT]), _epoch(epoch_domain::GetInstance())
+	{
+		size_t per_shard = 16;
+		while (per_shard * SHARD_COUNT < capacity) per_shard *= 2;
+		for (size_t i = 0; i < SHARD_COUNT; ++i) {
+			_shards[i].table.store(new Table(per_shard), std::memory_order_relaxed);
+			_shards[i].size = 0;
+		}
+	}
+
+	// Not safe against concurrent readers: callers must stop all threads first.
+	~concurrent_cstr_hash_map() noexcept {
+		clear();
+		for (size_t i = 0; i < SHARD_COUNT; ++i) {
+			for (size_t r = 0; r < _shards[i].retired.size(); ++r) {
+				_shards[i].retired[r].destroy(_shards[i].retired[r].ptr);
+			}
+			delete _shards[i].table.load(std::memory_order_relaxed);
+		}
+		delete[] _shards;
+	}
+
+	concurrent_cstr_hash_map(const concurrent_cstr_hash_map&) = delete;
+	concurrent_cstr_hash_map& operator=(const concurrent_cstr_hash_map&) = delete;
+	concurrent_cstr_hash_map(concurrent_cstr_hash_map&&) = delete;
+	concurrent_cstr_hash_map& operator=(concurrent_cstr_hash_map&&) = delete;
+
+	// Lock-free read. The value is copied out while the node is protected by the epoch guard.
+	bool find(const char* key, V& out) const noexcept {
+		const uint64_t hash_value = hash_func(key);
+		const Shard& shard = shard_of(hash_value);
+		epoch_domain::guard g(_epoch);
+		const Table* table = shard.table.load(std::memory_order_acquire);
+		const Node* node = bucket_of(table, hash_value).load(std::memory_order_acquire);
+		while (node) {
+			if (node->hash == hash_value && cstr_eq(node->key, key)) {
+				out = node->value;
+				return true;
+			}
+			node = node->next.load(std::memory_order_acquire);
+		}
+		return false;
+	}
+
+	bool contains(const char* key) const noexcept {
+		const uint64_t hash_value = hash_func(key);
+		const Shard& shard = shard_of(hash_value);
+		epoch_domain::guard g(_epoch);
+		const Table* table = shard.table.load(std::memory_order_acquire);
+		const Node* node = bucket_of(table, hash_value).load(std::memory_order_acquire);
+		while (node) {
+			if (node->hash == hash_value && cstr_eq(node->key, key)) return true;
+			node = node->next.load(std::memory_order_acquire);
+		}
+		return false;
+	}
+
+	// Insert or assign.
+	void insert(const char* key, const V& value) noexcept {
+		const uint64_t hash_value = hash_func(key);
+		Shard& shard = shard_of(hash_value);
+		Win::LockGuard lock(shard.lock);
+
+		Table* table = shard.table.load(std::memory_order_relaxed);
+		std::atomic<Node*>* link = &bucket_of(table, hash_value);
+		Node* node = link->load(std::memory_order_relaxed);
+		while (node) {
+			if (node->hash == hash_value && cstr_eq(node->key, key)) {
+				Node* replacement = new Node(node->key, hash_value, value, node->next.load(std::memory_order_relaxed));
+				link->store(replacement, std::memory_order_release);
+				retire(shard, node, &destroy_node);
+				return;
+			}
+			link = &node->next;
+			node = link->load(std::memory_order_relaxed);
+		}
+
+		if (shard.size >= static_cast<size_t>((table->mask + 1) * LOAD_FACTOR)) {
+			grow(shard);
+			table = shard.table.load(std::memory_order_relaxed);
+		}
+		std::atomic<Node*>& head = bucket_of(table, hash_value);
+		head.store(new Node(key, hash_value, value, head.load(std::memory_order_relaxed)), std::memory_order_release);
+		++shard.size;
+	}
+
+	bool erase(const char* key) noexcept {
+		const uint64_t hash_value = hash_func(key);
+		Shard& shard = shard_of(hash_value);
+		Win::LockGuard lock(shard.lock);
+
+		Table* table = shard.table.load(std::memory_order_relaxed);
+		std::atomic<Node*>* link = &bucket_of(table, hash_value);
+		Node* node = link->load(std::memory_order_relaxed);
+		while (node) {
+			if (node->hash == hash_value && cstr_eq(node->key, key)) {
+				link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+				retire(shard, node, &destroy_node);
+				--shard.size;
+				return true;
+			}
+			link = &node->next;
+			node = link->load(std::memory_order_relaxed);
+		}
+		return false;
+	}
+
+	void clear() noexcept {
+		for (size_t i = 0; i < SHARD_COUNT; ++i) {
+			Shard& shard = _shards[i];
+			Win::LockGuard lock(shard.lock);
+			// Swap in an empty table of the same capacity and retire the old one with its chains
+			Table* table = shard.table.load(std::memory_order_relaxed);
+			shard.table.store(new Table(table->mask + 1), std::memory_order_release);
+			retire(shard, table, &destroy_table);
+			shard.size = 0;
+			reclaim(shard);
+		}
+	}
+
+	// Sum of per-shard sizes; only a snapshot while writers are running.
+	size_t size() const noexcept {
+		size_t total = 0;
+		for (size_t i = 0; i < SHARD_COUNT; ++i) {
+			Win::LockGuard lock(_shards[i].lock);
+			total += _shards[i].size;
+		}
+		return total;
+	}
+	bool empty() const noexcept { return size() == 0; }
+};
+
+/*
+Concurrent companion of cstr_hash_map for tables shared across worker threads.
+Same key rules: keys are C-style strings that outlive the map (.rodata literals or interned).
+1. Sharding:
+   - 2^SHARD_BITS shards picked by the top bits of a finalized 64-bit djb2 hash.
+   - Each shard owns its bucket table, its Win::Mutex for writers and its retired list,
+     aligned to its own cache line so writers on different shards do not contend.
+2. Lock-free readers:
+   - find / contains load the shard table and chain with acquire loads and never lock.
+   - Published nodes are immutable; insert on an existing key publishes a replacement node.
+   - Growing a shard clones its nodes into a new table, so a reader on the old table
+     still sees a complete chain.
+3. Reclamation:
+   - Unlinked nodes and old tables are retired with the current epoch (epoch_domain);
+     a table replaced by grow or clear is retired as one entry that frees its chains too.
+   - A reclaim pass advances the epoch and frees entries older than every active reader.
+   - Values are returned by copy, so no reference outlives the reader's guard.
+   - Each reader thread holds one of epoch_domain::MAX_THREADS slots until it exits;
+     a thread beyond that calls std::terminate rather than spin waiting for a slot.
+*/
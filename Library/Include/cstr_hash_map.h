@@ -1,90 +1,466 @@
 #pragma once 
 
+#include <exception>
+#include <type_traits>
+#include <string_view>
+#include <iterator>
+
 // cstr_hash_map: A hash map implementation with C-style string keys and generic value type V.
 
+constexpr size_t cstr_length(const char* key) noexcept {
+	size_t length = 0;
+	while (key[length]) ++length;
+	return length;
+}
+
+constexpr uint64_t cstr_hash_round(uint64_t hash, uint64_t word) noexcept {
+	hash ^= word * 0x9e3779b97f4a7c15ULL;
+	return ((hash << 31) | (hash >> 33)) * 0xc2b2ae3d27d4eb4fULL;
+}
+
+constexpr size_t cstr_hash_finish(uint64_t hash, size_t length) noexcept {
+	hash ^= static_cast<uint64_t>(length);
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return static_cast<size_t>(hash);
+}
+
+// Hash used by every cstr container: one multiply-rotate round per 8 byte little-endian word, 
+// the last partial word zero padded, then a murmur3 finalizer. 
+// constexpr, so a literal key can be hashed at compile time: 
+//   constexpr size_t h = cstr_hash("Net::Send"); map.find("Net::Send", h); 
+constexpr size_t cstr_hash(const char* key, size_t length) noexcept {
+	uint64_t hash = 0;
+	for (size_t pos = 0; pos < length; pos += 8) {
+		uint64_t word = 0;
+		for (size_t i = 0; i < 8 && pos + i < length; ++i) {
+			word |= static_cast<uint64_t>(static_cast<unsigned char>(key[pos + i])) << (i * 8);
+		}
+		hash = cstr_hash_round(hash, word);
+	}
+	return cstr_hash_finish(hash, length);
+}
+constexpr size_t cstr_hash(const char* key) noexcept { return cstr_hash(key, cstr_length(key)); }
+
+// Same value as the constexpr overloads, with real 8 byte loads. Used for every runtime key, 
+// including views into a received packet that are not NUL-terminated. 
+inline size_t cstr_hash(std::string_view key) noexcept {
+	const char* data = key.data();
+	const size_t length = key.size();
+	uint64_t hash = 0;
+	size_t pos = 0;
+	for (; pos + 8 <= length; pos += 8) {
+		uint64_t word;
+		memcpy(&word, data + pos, 8);
+		hash = cstr_hash_round(hash, word);
+	}
+	if (pos < length) {
+		uint64_t word = 0;
+		memcpy(&word, data + pos, length - pos);
+		hash = cstr_hash_round(hash, word);
+	}
+	return cstr_hash_finish(hash, length);
+}
+
+// Node allocator policies for cstr_hash_map. 
+// A policy is instantiated with the node type and provides 
+//   void* allocate() / void deallocate(void*)  : one node worth of raw memory, allocate returns nullptr when out of memory 
+//   void release_all()                         : drop every node at once, no destructors run 
+//   BULK_RELEASE                               : true if release_all is cheaper than per-node deallocate 
+// and must be move-constructible / move-assignable, a moved-from policy owning no memory. 
+
+// Per-map slab allocator: nodes are carved out of malloc'd slabs in insertion order, 
+// freed nodes go to an intrusive free list, and release_all frees whole slabs. 
+template<typename T>
+class slab_node_allocator {
+private:
+	static constexpr size_t FIRST_SLAB_NODES = 32;
+	static constexpr size_t MAX_SLAB_NODES = 65536;
+
+	union Slot {
+		Slot* next; // valid only while the slot sits in the free list 
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+	struct Slab {
+		Slab* next;
+		size_t count;
+		inline Slot* slots() noexcept {
+			return reinterpret_cast<Slot*>(reinterpret_cast<char*>(this) + SLOT_OFFSET);
+		}
+	};
+	static constexpr size_t SLOT_OFFSET = (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+	Slab* _slabs;     // newest (largest) slab first 
+	Slot* _free_list;
+	size_t _used;     // slots handed out from the front of _slabs 
+
+	bool add_slab() noexcept {
+		size_t count = _slabs ? _slabs->count * 2 : FIRST_SLAB_NODES;
+		if (count > MAX_SLAB_NODES) count = MAX_SLAB_NODES;
+		Slab* slab = static_cast<Slab*>(malloc(SLOT_OFFSET + sizeof(Slot) * count));
+		if (!slab) return false;
+		slab->next = _slabs;
+		slab->count = count;
+		_slabs = slab;
+		_used = 0;
+		return true;
+	}
+
+	void free_slabs() noexcept {
+		while (_slabs) {
+			Slab* next = _slabs->next;
+			free(_slabs);
+			_slabs = next;
+		}
+		_free_list = nullptr;
+		_used = 0;
+	}
+
+public:
+	static constexpr bool BULK_RELEASE = true;
+
+	slab_node_allocator() noexcept : _slabs(nullptr), _free_list(nullptr), _used(0) {}
+	~slab_node_allocator() noexcept { free_slabs(); }
+	slab_node_allocator(const slab_node_allocator&) = delete;
+	slab_node_allocator& operator=(const slab_node_allocator&) = delete;
+
+	slab_node_allocator(slab_node_allocator&& other) noexcept
+		: _slabs(other._slabs), _free_list(other._free_list), _used(other._used)
+	{
+		other._slabs = nullptr;
+		other._free_list = nullptr;
+		other._used = 0;
+	}
+	slab_node_allocator& operator=(slab_node_allocator&& other) noexcept {
+		if (this == &other) return *this;
+		free_slabs();
+		_slabs = other._slabs;
+		_free_list = other._free_list;
+		_used = other._used;
+		other._slabs = nullptr;
+		other._free_list = nullptr;
+		other._used = 0;
+		return *this;
+	}
+
+	inline void* allocate() noexcept {
+		if (_free_list) {
+			Slot* slot = _free_list;
+			_free_list = slot->next;
+			return slot;
+		}
+		if (!_slabs || _used == _slabs->count) {
+			if (!add_slab()) return nullptr;
+		}
+		return _slabs->slots() + _used++;
+	}
+
+	inline void deallocate(void* p) noexcept {
+		Slot* slot = static_cast<Slot*>(p);
+		slot->next = _free_list;
+		_free_list = slot;
+	}
+
+	// O(slabs). Keeps the newest slab so a refill after clear() does not hit malloc again. 
+	void release_all() noexcept {
+		if (!_slabs) return;
+		Slab* slab = _slabs->next;
+		while (slab) {
+			Slab* next = slab->next;
+			free(slab);
+			slab = next;
+		}
+		_slabs->next = nullptr;
+		_free_list = nullptr;
+		_used = 0;
+	}
+};
+
+// One new / delete per node, the original cstr_hash_map behaviour. 
+template<typename T>
+class heap_node_allocator {
+public:
+	static constexpr bool BULK_RELEASE = false;
+
+	inline void* allocate() noexcept { return ::operator new(sizeof(T), std::nothrow); }
+	inline void deallocate(void* p) noexcept { ::operator delete(p); }
+	inline void release_all() noexcept {}
+};
+
+// Snapshot file written by cstr_hash_map::save and mapped by cstr_hash_map_view. 
+// Offsets are from the start of the file, every section starts on a 64 byte boundary: 
+//   header | bucket starts (bucket_count + 1 entry indices) | entries | string pool 
+// Entries are grouped by bucket, so a chain is the contiguous run [starts[b], starts[b + 1]). 
+struct cstr_snapshot_header {
+	static constexpr uint32_t MAGIC = 0x4D485343; // "CSHM" 
+	static constexpr uint32_t VERSION = 1;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t word_size;  // sizeof(size_t) of the writer, cstr_hash is size_t wide 
+	uint32_t value_size; // sizeof(V) 
+	uint64_t size;
+	uint64_t bucket_count; // power of two 
+	uint64_t buckets;
+	uint64_t entries;
+	uint64_t strings;
+	uint64_t file_size;
+};
+
 template<typename V>
+struct cstr_snapshot_entry {
+	uint64_t hash;
+	uint32_t key;    // offset in the string pool, NUL-terminated 
+	uint32_t length;
+	V value;
+};
+
+// Runs task(context, begin, end) over [0, count) split across up to thread_count threads
+// (0 = one per processor, at most one per min_per_thread items); the calling thread takes the first chunk.
+// A chunk whose thread cannot be created runs on the calling thread, so every item is always processed.
+// Defined in cstr_hash_map.cpp, which keeps _beginthreadex out of this header.
+void cstr_parallel_for(size_t count, size_t min_per_thread, unsigned int thread_count,
+	void (*task)(void*, size_t, size_t), void* context) noexcept;
+
+template<typename V, template<typename> class NodeAllocator = slab_node_allocator>
 class cstr_hash_map {
-private:
+private: 
 	static constexpr float LOAD_FACTOR = 0.75f;
+	static constexpr size_t DEFAULT_CAPACITY = 64;
+	static constexpr size_t BUILD_MIN_KEYS_PER_THREAD = 65536; // smaller inputs are hashed on the calling thread
+	static constexpr size_t REHASH_STEP = 8; // old buckets migrated per mutating call in incremental mode
 
 	struct Node {
 		const char* key;
+		size_t length; // key length, so a compare is a length check plus one memcmp 
+		size_t hash; // full hash_func(key), cached so rehash never re-reads the key 
 		V value;
 		Node* next;
-		Node(const char* k, V v) noexcept : key(k), value(v), next(nullptr) {}
+		template<typename... Args>
+		Node(std::string_view k, size_t h, Args&&... args) noexcept
+			: key(k.data()), length(k.size()), hash(h), value(std::forward<Args>(args)...), next(nullptr) {}
 	};
 
 	size_t _capacity;
 	size_t _size;
 	Node** _bucket;
+	NodeAllocator<Node> _alloc;
+
+	// Incremental rehash state. While _old_bucket is not null, nodes live in both tables:
+	// old buckets [0, _migrate_index) are already drained into _bucket.
+	bool _incremental;
+	size_t _old_capacity;
+	size_t _migrate_index;
+	Node** _old_bucket;
 
 private: 
 
-	inline static int cstr_cmp(const char* a, const char* b) noexcept {
-		if (a == b) return 0; 
-		while (*a && (*a == *b)) { ++a; ++b; }
-		return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+	inline static bool key_equal(const Node* node, std::string_view key, size_t hash_value) noexcept {
+		return node->hash == hash_value && node->length == key.size()
+			&& (node->key == key.data() || memcmp(node->key, key.data(), key.size()) == 0);
+	}
+
+	inline static size_t hash_func(std::string_view key) noexcept { return cstr_hash(key); }
+
+	// calloc instead of new[]() : large zeroed blocks come straight from fresh OS pages,
+	// so doubling the table does not memset it up front and the page faults spread over later calls.
+	// nullptr on failure: growing keeps the current table (longer chains, still correct),
+	// a map left without any table terminates like a bad_alloc inside noexcept.
+	inline static Node** alloc_buckets(size_t capacity) noexcept {
+		return static_cast<Node**>(calloc(capacity, sizeof(Node*)));
+	}
+
+	// Out of memory: there is no node to link or return, so fail loudly as with a bad_alloc inside noexcept.
+	template<typename... Args>
+	inline Node* new_node(std::string_view key, size_t hash_value, Args&&... args) noexcept {
+		void* memory = _alloc.allocate();
+		if (!memory) std::terminate();
+		return new (memory) Node(key, hash_value, std::forward<Args>(args)...);
+	}
+
+	inline void delete_node(Node* node) noexcept {
+		node->~Node();
+		_alloc.deallocate(node);
+	}
+
+	void destroy_values(std::true_type /* trivially destructible */) noexcept {}
+	void destroy_values(std::false_type) noexcept {
+		for (size_t i = 0; i < _capacity; ++i) {
+			Node* node = _bucket[i];
+			while (node) {
+				Node* temp = node;
+				node = node->next;
+				temp->~Node();
+			}
+		}
+	}
+
+	void clear_nodes(std::true_type /* bulk release */) noexcept {
+		destroy_values(std::is_trivially_destructible<V>());
+		_alloc.release_all();
+		memset(_bucket, 0, sizeof(Node*) * _capacity);
+	}
+	void clear_nodes(std::false_type) noexcept {
+		for (size_t i = 0; i < _capacity; ++i) {
+			Node* node = _bucket[i];
+			while (node) {
+				Node* temp = node;
+				node = node->next;
+				delete_node(temp);
+			}
+			_bucket[i] = nullptr;
+		}
 	}
 
-	inline static size_t hash_func(const char* key) noexcept {
-		size_t hash = 5381;
-		while (*key) {
-			hash = ((hash << 5) + hash) + static_cast<unsigned char>(*key++);
+	inline static Node* find_in(Node* node, std::string_view key, size_t hash_value) noexcept {
+		while (node) {
+			if (key_equal(node, key, hash_value)) return node;
+			node = node->next;
 		}
-		return hash;
+		return nullptr;
 	}
 
 	void rehash() noexcept { 
+		finish_rehash();
 		size_t newCapacity = _capacity * 2;
-		Node** newBucket = new Node * [newCapacity](); // can throw std::bad_alloc but ignore 
+		Node** newBucket = alloc_buckets(newCapacity);
+		if (!newBucket) return;
 		for (size_t i = 0; i < _capacity; ++i) {
 			Node* node = _bucket[i];
 			while (node) {
 				Node* nextNode = node->next;
-				size_t idx = hash_func(node->key) % newCapacity;
+				size_t idx = node->hash % newCapacity;
 				node->next = newBucket[idx];
 				newBucket[idx] = node;
 				node = nextNode;
 			}
 		}
-		delete[] _bucket;
+		free(_bucket);
 		_bucket = newBucket;
 		_capacity = newCapacity;
 	}
 
+	void start_rehash() noexcept {
+		finish_rehash();
+		Node** newBucket = alloc_buckets(_capacity * 2);
+		if (!newBucket) return;
+		_old_bucket = _bucket;
+		_old_capacity = _capacity;
+		_migrate_index = 0;
+		_capacity = _capacity * 2;
+		_bucket = newBucket;
+	}
+
+	void migrate(size_t bucket_count) noexcept {
+		if (!_old_bucket) return;
+		size_t last = _migrate_index + bucket_count;
+		if (last > _old_capacity) last = _old_capacity;
+		for (; _migrate_index < last; ++_migrate_index) {
+			Node* node = _old_bucket[_migrate_index];
+			while (node) {
+				Node* nextNode = node->next;
+				size_t idx = node->hash % _capacity;
+				node->next = _bucket[idx];
+				_bucket[idx] = node;
+				node = nextNode;
+			}
+			_old_bucket[_migrate_index] = nullptr;
+		}
+		if (_migrate_index == _old_capacity) {
+			free(_old_bucket);
+			_old_bucket = nullptr;
+			_old_capacity = 0;
+			_migrate_index = 0;
+		}
+	}
+
+	inline void finish_rehash() noexcept { migrate(_old_capacity); }
+
+	inline void grow_if_needed() noexcept {
+		if (_size < static_cast<size_t>(_capacity * LOAD_FACTOR)) return;
+		if (_incremental) start_rehash();
+		else rehash();
+	}
+
 public:
 	cstr_hash_map(const cstr_hash_map&) = delete;
 	cstr_hash_map& operator=(const cstr_hash_map&) = delete;
-	cstr_hash_map(cstr_hash_map&&) = delete;
-	cstr_hash_map& operator=(cstr_hash_map&&) = delete;
+
+	// Steals the tables and the node allocator; the source is left empty with a fresh default table. 
+	cstr_hash_map(cstr_hash_map&& other) noexcept
+		: _capacity(other._capacity), _size(other._size), _bucket(other._bucket), _alloc(std::move(other._alloc)),
+		_incremental(other._incremental), _old_capacity(other._old_capacity),
+		_migrate_index(other._migrate_index), _old_bucket(other._old_bucket)
+	{
+		other.reset_empty();
+	}
+	cstr_hash_map& operator=(cstr_hash_map&& other) noexcept {
+		if (this == &other) return *this;
+		clear();
+		free(_bucket);
+		_capacity = other._capacity;
+		_size = other._size;
+		_bucket = other._bucket;
+		_alloc = std::move(other._alloc);
+		_incremental = other._incremental;
+		_old_capacity = other._old_capacity;
+		_migrate_index = other._migrate_index;
+		_old_bucket = other._old_bucket;
+		other.reset_empty();
+		return *this;
+	}
 
 	size_t size() const noexcept { return _size; }
 	bool empty() const noexcept { return _size == 0; }
 	bool contains(const char* key) noexcept { return find(key) != end(); }
+	bool contains(const char* key, size_t hash_value) noexcept { return find(key, hash_value) != end(); }
+	bool contains(std::string_view key) noexcept { return find(key) != end(); }
+	bool contains(std::string_view key, size_t hash_value) noexcept { return find(key, hash_value) != end(); }
 	float load_factor() const noexcept {
 		return static_cast<float>(_size) / static_cast<float>(_capacity);
 	}
 	void reserve(size_t new_capacity) noexcept {
+		finish_rehash();
 		while (_capacity < new_capacity) rehash();
 	}
 
+	// Incremental mode: crossing the load factor allocates the doubled table only,
+	// then every insert / operator[] / erase migrates REHASH_STEP old buckets.
+	// Worst-case latency per call is bounded by one allocation instead of a full rehash.
+	void set_incremental_rehash(bool enable) noexcept {
+		if (!enable) finish_rehash();
+		_incremental = enable;
+	}
+	bool is_incremental_rehash() const noexcept { return _incremental; }
+	bool is_rehashing() const noexcept { return _old_bucket != nullptr; }
+
 	class iterator {
 	private:
 		Node* _node;
 		Node** _buckets;
 		size_t _capacity;
 		size_t _bucket_index;
+		Node** _next_buckets; // table walked after _buckets while a rehash is in progress
+		size_t _next_capacity;
 
 	public:
 		iterator() noexcept
-			: _node(nullptr), _buckets(nullptr), _capacity(0), _bucket_index(0) {
+			: _node(nullptr), _buckets(nullptr), _capacity(0), _bucket_index(0),
+			_next_buckets(nullptr), _next_capacity(0) {
 		}
 
-		iterator(Node* n, Node** b, size_t cap, size_t idx) noexcept
-			: _node(n), _buckets(b), _capacity(cap), _bucket_index(idx) {
+		iterator(Node* n, Node** b, size_t cap, size_t idx,
+			Node** nb = nullptr, size_t ncap = 0) noexcept
+			: _node(n), _buckets(b), _capacity(cap), _bucket_index(idx),
+			_next_buckets(nb), _next_capacity(ncap) {
 		}
 
 		const char* key() const noexcept { return _node->key; }
+		std::string_view key_view() const noexcept { return { _node->key, _node->length }; }
 		V& value() noexcept { return _node->value; }
 		const V& value() const noexcept { return _node->value; }
 
@@ -106,11 +482,19 @@ public:
 				_node = _node->next;
 				return *this;
 			}
-			for (++_bucket_index; _bucket_index < _capacity; ++_bucket_index) {
-				if (_buckets[_bucket_index]) {
-					_node = _buckets[_bucket_index];
-					return *this;
+			for (;;) {
+				for (++_bucket_index; _bucket_index < _capacity; ++_bucket_index) {
+					if (_buckets[_bucket_index]) {
+						_node = _buckets[_bucket_index];
+						return *this;
+					}
 				}
+				if (!_next_buckets) break;
+				_buckets = _next_buckets;
+				_capacity = _next_capacity;
+				_bucket_index = static_cast<size_t>(-1);
+				_next_buckets = nullptr;
+				_next_capacity = 0;
 			}
 			_node = nullptr;
 			_bucket_index = _capacity;
@@ -130,16 +514,22 @@ public:
 		Node* const* _buckets;
 		size_t _capacity;
 		size_t _bucket_index;
+		Node* const* _next_buckets;
+		size_t _next_capacity;
 	public:
 		const_iterator() noexcept
-			: _node(nullptr), _buckets(nullptr), _capacity(0), _bucket_index(0) {
+			: _node(nullptr), _buckets(nullptr), _capacity(0), _bucket_index(0),
+			_next_buckets(nullptr), _next_capacity(0) {
 		}
 
-		const_iterator(const Node* n, Node* const* b, size_t cap, size_t idx) noexcept
-			: _node(n), _buckets(b), _capacity(cap), _bucket_index(idx) {
+		const_iterator(const Node* n, Node* const* b, size_t cap, size_t idx,
+			Node* const* nb = nullptr, size_t ncap = 0) noexcept
+			: _node(n), _buckets(b), _capacity(cap), _bucket_index(idx),
+			_next_buckets(nb), _next_capacity(ncap) {
 		}
 
 		const char* key() const noexcept { return _node->key; }
+		std::string_view key_view() const noexcept { return { _node->key, _node->length }; }
 		const V& value() const noexcept { return _node->value; }
 
 		std::pair<const char*, const V&> operator*() const noexcept {
@@ -151,11 +541,19 @@ public:
 				_node = _node->next;
 				return *this;
 			}
-			for (++_bucket_index; _bucket_index < _capacity; ++_bucket_index) {
-				if (_buckets[_bucket_index]) {
-					_node = _buckets[_bucket_index];
-					return *this;
+			for (;;) {
+				for (++_bucket_index; _bucket_index < _capacity; ++_bucket_index) {
+					if (_buckets[_bucket_index]) {
+						_node = _buckets[_bucket_index];
+						return *this;
+					}
 				}
+				if (!_next_buckets) break;
+				_buckets = _next_buckets;
+				_capacity = _next_capacity;
+				_bucket_index = static_cast<size_t>(-1);
+				_next_buckets = nullptr;
+				_next_capacity = 0;
 			}
 			_node = nullptr;
 			_bucket_index = _capacity;
@@ -170,7 +568,13 @@ public:
 		}
 	};
 
+	// While rehashing, iteration walks the undrained part of the old table first, then the new one.
 	const_iterator begin() const noexcept {
+		for (size_t i = _migrate_index; i < _old_capacity; ++i) {
+			if (_old_bucket[i]) {
+				return const_iterator(_old_bucket[i], _old_bucket, _old_capacity, i, _bucket, _capacity);
+			}
+		}
 		for (size_t i = 0; i < _capacity; ++i) {
 			if (_bucket[i]) {
 				return const_iterator(_bucket[i], _bucket, _capacity, i);
@@ -185,6 +589,11 @@ public:
 
 
 	iterator begin() noexcept {
+		for (size_t i = _migrate_index; i < _old_capacity; ++i) {
+			if (_old_bucket[i]) {
+				return iterator(_old_bucket[i], _old_bucket, _old_capacity, i, _bucket, _capacity);
+			}
+		}
 		for (size_t i = 0; i < _capacity; ++i) {
 			if (_bucket[i]) {
 				return iterator(_bucket[i], _bucket, _capacity, i);
@@ -197,104 +606,287 @@ public:
 		return iterator(nullptr, _bucket, _capacity, _capacity);
 	}
 
-	iterator find(const char* key) noexcept {
-		size_t idx = hash_func(key) % _capacity;
-		Node* node = _bucket[idx];
-		while (node) {
-			if (cstr_cmp(node->key, key) == 0) {
-				return iterator(node, _bucket, _capacity, idx);
-			}
-			node = node->next;
+private:
+	// Single insertion path: V is constructed in place from args only when the key is missing. 
+	template<typename... Args>
+	std::pair<iterator, bool> emplace_node(std::string_view key, size_t hash_value, Args&&... args) noexcept {
+		migrate(REHASH_STEP);
+		size_t idx = hash_value % _capacity;
+		Node* node = find_in(_bucket[idx], key, hash_value);
+		if (node) return { iterator(node, _bucket, _capacity, idx), false };
+		if (_old_bucket) {
+			size_t old_idx = hash_value % _old_capacity;
+			node = find_in(_old_bucket[old_idx], key, hash_value);
+			if (node) return { iterator(node, _old_bucket, _old_capacity, old_idx, _bucket, _capacity), false };
 		}
-		return end();
-	}
 
-	void insert(const char* key, V value) noexcept {
-		if (_size >= static_cast<size_t>(_capacity * LOAD_FACTOR)) {
-			rehash();
-		}
-		size_t idx = hash_func(key) % _capacity;
-		Node* node = _bucket[idx];
-		while (node) {
-			if (cstr_cmp(node->key, key) == 0) {
-				node->value = value;
-				return;
-			}
-			node = node->next;
-		}
-		Node* newNode = new Node(key, value); // can throw std::bad_alloc but ignore 
+		grow_if_needed();
+		idx = hash_value % _capacity;
+		Node* newNode = new_node(key, hash_value, std::forward<Args>(args)...);
 		newNode->next = _bucket[idx];
 		_bucket[idx] = newNode;
 		++_size;
+		return { iterator(newNode, _bucket, _capacity, idx), true };
 	}
 
-	V& operator[](const char* key) noexcept {
-		const size_t hash_value = hash_func(key); 
-		size_t idx = hash_value % _capacity;
-		Node* node = _bucket[idx];
+	template<typename Func>
+	static void run_range(void* context, size_t begin, size_t end) noexcept { (*static_cast<Func*>(context))(begin, end); }
 
-		while (node) {
-			if (cstr_cmp(node->key, key) == 0) {
-				return node->value;
-			}
-			node = node->next;
+	inline void assign_node(std::string_view key, size_t hash_value, V value) noexcept {
+		std::pair<iterator, bool> result = emplace_node(key, hash_value, std::move(value));
+		if (!result.second) result.first.value() = std::move(value); // not consumed when the key exists
+	}
+
+	template<typename Func>
+	void for_each_node(Func func) const noexcept {
+		for (size_t i = _migrate_index; i < _old_capacity; ++i) {
+			for (const Node* node = _old_bucket[i]; node; node = node->next) func(node);
+		}
+		for (size_t i = 0; i < _capacity; ++i) {
+			for (const Node* node = _bucket[i]; node; node = node->next) func(node);
 		}
+	}
+
+	inline static uint64_t snapshot_align(uint64_t offset) noexcept { return (offset + 63) & ~static_cast<uint64_t>(63); }
 
-		if (_size >= static_cast<size_t>(_capacity * LOAD_FACTOR)) {
-			rehash();
-			idx = hash_value % _capacity;
+	inline static bool write_at(FILE* file, uint64_t& written, uint64_t offset, const void* data, size_t bytes) noexcept {
+		static const char zeros[64] = {};
+		while (written < offset) {
+			size_t pad = static_cast<size_t>(offset - written < sizeof(zeros) ? offset - written : sizeof(zeros));
+			if (fwrite(zeros, 1, pad, file) != pad) return false;
+			written += pad;
 		}
+		if (bytes && fwrite(data, 1, bytes, file) != bytes) return false;
+		written += bytes;
+		return true;
+	}
 
-		Node* newNode = new Node(key, V{});
-		newNode->next = _bucket[idx];
-		_bucket[idx] = newNode;
-		++_size;
-		return newNode->value;
+	// Leaves the map empty and usable without touching the nodes it owned (they were handed over). 
+	void reset_empty() noexcept {
+		_capacity = DEFAULT_CAPACITY;
+		_size = 0;
+		_bucket = alloc_buckets(_capacity);
+		if (!_bucket) std::terminate();
+		_old_capacity = 0;
+		_migrate_index = 0;
+		_old_bucket = nullptr;
 	}
 
-	void erase(const char* key) noexcept {
-		size_t idx = hash_func(key) % _capacity;
-		Node* curr = _bucket[idx];
-		Node* prev = nullptr;
-		while (curr) {
-			if (cstr_cmp(curr->key, key) == 0) {
-				if (prev == nullptr) {
-					_bucket[idx] = curr->next;
-				}
-				else {
-					prev->next = curr->next;
+public:
+	// Overloads taking hash_value skip only the hash rounds; hash_value must equal cstr_hash(key).
+	// const char* keys are still measured once with strlen and then take the same path as string_view keys,
+	// which memcmp the key against any node whose hash and length match.
+
+	// find does not migrate buckets, so lookups never invalidate live iterators.
+	// A string_view key need not be NUL-terminated: names can be looked up in place inside a packet.
+	iterator find(const char* key) noexcept { return find(std::string_view(key)); }
+	iterator find(const char* key, size_t hash_value) noexcept { return find(std::string_view(key), hash_value); }
+	iterator find(std::string_view key) noexcept { return find(key, hash_func(key)); }
+	iterator find(std::string_view key, size_t hash_value) noexcept {
+		size_t idx = hash_value % _capacity;
+		Node* node = find_in(_bucket[idx], key, hash_value);
+		if (node) return iterator(node, _bucket, _capacity, idx);
+		if (_old_bucket) {
+			idx = hash_value % _old_capacity;
+			node = find_in(_old_bucket[idx], key, hash_value);
+			if (node) return iterator(node, _old_bucket, _old_capacity, idx, _bucket, _capacity);
+		}
+		return end();
+	}
+
+	// Inserting overloads take NUL-terminated const char* keys only: the map stores the pointer itself,
+	// and key() hands it back as a C string. The characters must outlive the map like any other key;
+	// transient views (packet contents) go through cstr_interner::intern first.
+
+	// Insert or assign. value is moved into the node (or onto the existing value), never copied again.
+	void insert(const char* key, V value) noexcept {
+		const std::string_view view(key);
+		assign_node(view, hash_func(view), std::move(value));
+	}
+	void insert(const char* key, size_t hash_value, V value) noexcept {
+		assign_node(std::string_view(key), hash_value, std::move(value));
+	}
+
+	// Constructs V in place from args if key is missing; otherwise args are left untouched.
+	// Returns the entry and whether it was inserted.
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const char* key, Args&&... args) noexcept {
+		std::string_view view(key);
+		return emplace_node(view, hash_func(view), std::forward<Args>(args)...);
+	}
+
+	// Keys are plain pointers, so there is no key / value pair to build up front:
+	// emplace behaves exactly like try_emplace and never overwrites.
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(const char* key, Args&&... args) noexcept {
+		return try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	// A missing key gets a value-initialized V built in the node, no V{} temporary.
+	V& operator[](const char* key) noexcept { return get_or_insert(key); }
+	V& get_or_insert(const char* key) noexcept {
+		const std::string_view view(key);
+		return emplace_node(view, hash_func(view)).first.value();
+	}
+	V& get_or_insert(const char* key, size_t hash_value) noexcept {
+		return emplace_node(std::string_view(key), hash_value).first.value();
+	}
+
+	void erase(const char* key) noexcept { erase(std::string_view(key)); }
+	void erase(const char* key, size_t hash_value) noexcept { erase(std::string_view(key), hash_value); }
+	void erase(std::string_view key) noexcept { erase(key, hash_func(key)); }
+	void erase(std::string_view key, size_t hash_value) noexcept {
+		migrate(REHASH_STEP);
+		Node** slot = &_bucket[hash_value % _capacity];
+		for (int table = 0; table < 2; ++table) {
+			Node* curr = *slot;
+			Node* prev = nullptr;
+			while (curr) {
+				if (key_equal(curr, key, hash_value)) {
+					if (prev == nullptr) {
+						*slot = curr->next;
+					}
+					else {
+						prev->next = curr->next;
+					}
+					delete_node(curr);
+					--_size;
+					return;
 				}
-				delete curr;
-				--_size;
-				return;
+				prev = curr;
+				curr = curr->next;
 			}
-			prev = curr;
-			curr = curr->next;
+			if (!_old_bucket) return;
+			slot = &_old_bucket[hash_value % _old_capacity];
 		}
 	}
 
-	void clear() noexcept {
-		for (size_t i = 0; i < _capacity; ++i) {
-			Node* node = _bucket[i];
-			while (node) {
-				Node* temp = node;
-				node = node->next;
-				delete temp;
+	// Replaces the contents with [first, last): *first needs .first (const char* key, NUL-terminated as for insert)
+	// and .second (V), e.g. std::pair<const char*, V>. The table is sized once, keys are hashed on
+	// up to thread_count threads (0 = one per processor), counting-sorted by bucket and linked
+	// in a single pass, so nodes of one chain are allocated next to each other.
+	// Duplicate keys keep the value of the last occurrence, like repeated insert calls.
+	template<typename RandomIt>
+	void build(RandomIt first, RandomIt last, unsigned int thread_count = 0) noexcept {
+		static_assert(std::is_base_of<std::random_access_iterator_tag,
+			typename std::iterator_traits<RandomIt>::iterator_category>::value, "build needs random access iterators");
+		clear();
+		const size_t count = static_cast<size_t>(last - first);
+		size_t capacity = _capacity;
+		while (count >= static_cast<size_t>(capacity * LOAD_FACTOR)) capacity *= 2;
+		Node** newBucket = capacity != _capacity ? alloc_buckets(capacity) : nullptr;
+		if (newBucket) { // on failure the current table is kept, with longer chains
+			free(_bucket);
+			_capacity = capacity;
+			_bucket = newBucket;
+		}
+		if (count == 0) return;
+
+		// 1. Hash every key and compute its bucket, in parallel on large inputs
+		std::vector<size_t> hashes(count);
+		auto hash_range = [&](size_t begin, size_t end) noexcept {
+			for (size_t i = begin; i < end; ++i) hashes[i] = hash_func(std::string_view(first[i].first));
+		};
+		cstr_parallel_for(count, BUILD_MIN_KEYS_PER_THREAD, thread_count, &run_range<decltype(hash_range)>, &hash_range);
+
+		// 2. Stable counting sort of the input indices by bucket
+		std::vector<size_t> starts(_capacity + 1, 0);
+		for (size_t i = 0; i < count; ++i) ++starts[hashes[i] % _capacity + 1];
+		for (size_t b = 0; b < _capacity; ++b) starts[b + 1] += starts[b];
+		std::vector<size_t> order(count);
+		for (size_t i = 0; i < count; ++i) order[starts[hashes[i] % _capacity]++] = i;
+
+		// 3. Link chains bucket by bucket; a chain only ever holds keys of the run being linked
+		for (size_t i : order) {
+			const char* const key_text = first[i].first;
+			const std::string_view key(key_text);
+			const size_t idx = hashes[i] % _capacity;
+			Node* node = find_in(_bucket[idx], key, hashes[i]);
+			if (node) {
+				node->value = first[i].second;
+				continue;
 			}
-			_bucket[i] = nullptr;
+			Node* newNode = new_node(key, hashes[i], first[i].second);
+			newNode->next = _bucket[idx];
+			_bucket[idx] = newNode;
+			++_size;
+		}
+	}
+
+	// Writes a snapshot of the map that cstr_hash_map_view<V> maps and queries in place.
+	// The file carries copies of the key strings, so it does not depend on where the keys lived.
+	// Returns false if the file cannot be written or the string pool exceeds 4GB.
+	bool save(const char* path) const noexcept {
+		static_assert(std::is_trivially_copyable<V>::value, "cstr_hash_map::save needs a trivially copyable V");
+		typedef cstr_snapshot_entry<V> Entry;
+
+		uint64_t bucket_count = 1;
+		while (bucket_count < _size) bucket_count <<= 1;
+		const uint64_t mask = bucket_count - 1;
+
+		// Counting sort of the nodes by snapshot bucket
+		std::vector<uint64_t> starts(static_cast<size_t>(bucket_count + 1), 0);
+		for_each_node([&](const Node* node) { ++starts[static_cast<size_t>((node->hash & mask) + 1)]; });
+		for (size_t b = 0; b < bucket_count; ++b) starts[b + 1] += starts[b];
+		std::vector<const Node*> ordered(_size);
+		std::vector<uint64_t> fill(starts.begin(), starts.end() - 1);
+		for_each_node([&](const Node* node) { ordered[static_cast<size_t>(fill[static_cast<size_t>(node->hash & mask)]++)] = node; });
+
+		std::vector<Entry> entries(_size);
+		std::vector<char> strings;
+		for (size_t i = 0; i < _size; ++i) {
+			const Node* node = ordered[i];
+			if (strings.size() + node->length + 1 > UINT32_MAX) return false;
+			entries[i].hash = node->hash;
+			entries[i].key = static_cast<uint32_t>(strings.size());
+			entries[i].length = static_cast<uint32_t>(node->length);
+			entries[i].value = node->value;
+			strings.insert(strings.end(), node->key, node->key + node->length);
+			strings.push_back('\0');
 		}
+
+		cstr_snapshot_header header = {};
+		header.magic = cstr_snapshot_header::MAGIC;
+		header.version = cstr_snapshot_header::VERSION;
+		header.word_size = static_cast<uint32_t>(sizeof(size_t));
+		header.value_size = static_cast<uint32_t>(sizeof(V));
+		header.size = _size;
+		header.bucket_count = bucket_count;
+		header.buckets = snapshot_align(sizeof(header));
+		header.entries = snapshot_align(header.buckets + sizeof(uint64_t) * starts.size());
+		header.strings = snapshot_align(header.entries + sizeof(Entry) * entries.size());
+		header.file_size = header.strings + strings.size();
+
+		FILE* file = nullptr;
+		if (fopen_s(&file, path, "wb") != 0 || !file) return false;
+		uint64_t written = 0;
+		bool ok = write_at(file, written, 0, &header, sizeof(header))
+			&& write_at(file, written, header.buckets, starts.data(), sizeof(uint64_t) * starts.size())
+			&& write_at(file, written, header.entries, entries.data(), sizeof(Entry) * entries.size())
+			&& write_at(file, written, header.strings, strings.data(), strings.size());
+		if (fclose(file) != 0) ok = false;
+		return ok;
+	}
+
+	// With a bulk-release allocator and trivially destructible V, nodes are never visited: 
+	// the slabs are dropped in O(slabs) and only the bucket array is zeroed. 
+	void clear() noexcept {
+		finish_rehash();
+		clear_nodes(std::integral_constant<bool, NodeAllocator<Node>::BULK_RELEASE>());
 		_size = 0;
 	}
 
-	explicit cstr_hash_map(size_t capacity = 64)
-		: _capacity(capacity), _size(0), _bucket(nullptr)
+	explicit cstr_hash_map(size_t capacity = DEFAULT_CAPACITY, bool incremental_rehash = false)
+		: _capacity(capacity), _size(0), _bucket(nullptr), _alloc(),
+		_incremental(incremental_rehash), _old_capacity(0), _migrate_index(0), _old_bucket(nullptr)
 	{
-		_bucket = new Node * [_capacity]();
+		_bucket = alloc_buckets(_capacity);
+		if (!_bucket) std::terminate();
 	}
 
 	~cstr_hash_map() noexcept {
 		clear();
-		delete[] _bucket;
+		free(_bucket);
 	}
 };
 
@@ -312,13 +904,39 @@ Features:
    - Nested class within cstr_hash_map to facilitate iteration over the map's elements.
    - Supports standard iterator operations like incrementing and dereferencing.
 3. Hash Function:
-   - A static method that computes a hash value for a given C-style string using the djb2 hash algorithm.
    - Rehashing mechanism to maintain performance as the number of elements grows. 
-   - Used FNV-1a hash algorithm first, but switched to djb2 for better speed 
+   - Used FNV-1a hash algorithm first, then djb2 for better speed. Both walked the key byte by byte;
+     cstr_hash now consumes 8 byte words over (pointer, length) and finishes with a murmur3 mix.
+   - The hash is the free constexpr function cstr_hash, so literal keys can be hashed at compile time
+     and passed to find / contains / insert / get_or_insert / erase overloads taking hash_value.
+     That saves the hash rounds only: the key is still measured and compared on a hash match.
+   - find / contains / erase also take std::string_view, so lookup keys need not be NUL-terminated:
+     a name can be looked up straight out of a SerialBuffer without copying.
+     Inserted keys stay const char*, since key() returns the stored pointer as a C string.
 4. Collision Handling:
    - Uses separate chaining (linked lists) to handle hash collisions.
    - Each bucket in the hash table points to a linked list of nodes that share the same hash index.
-5. Load Factor Management:
+   - Each node caches the full hash and the length of its key. Chain walks compare hashes and lengths
+     first and only memcmp on a match, and rehash redistributes nodes without touching key memory.
+5. Node Allocation:
+   - Nodes come from a NodeAllocator policy. The default slab_node_allocator carves nodes out of
+     per-map slabs with an intrusive free list, so inserts rarely reach malloc and nodes sit
+     close together in insertion order. clear() and the destructor free whole slabs.
+   - heap_node_allocator keeps the original one new / delete per node behaviour.
+   - Values are constructed in place: try_emplace / emplace forward their arguments to V's constructor,
+     insert moves its by-value argument, and operator[] value-initializes inside the node.
+   - The map is move-constructible and move-assignable (tables and allocator are stolen, nothing is copied),
+     so a map with heavy values such as std::vector can be returned or stored by value.
+6. Load Factor Management:
    - Automatically resizes the hash table when the load factor exceeds a predefined threshold (0.75).
    - Ensures efficient performance for insertions and lookups.
+   - Optional incremental rehash (set_incremental_rehash / constructor flag) keeps the old and new
+     bucket arrays alive together and drains a few old buckets per mutating call,
+     so no single insert pays for moving every node. find checks both tables until the drain completes.
+7. Bulk Load:
+   - build(first, last) sizes the table once, hashes the keys on several threads, counting-sorts them
+     by bucket and links every chain in one pass. No rehash happens during the load.
+8. Snapshots:
+   - save(path) writes the table as a flat file (bucket starts, entries, inline string pool)
+     that cstr_hash_map_view maps read-only and queries in place, with no deserialization.
 */
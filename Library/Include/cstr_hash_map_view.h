@@ -0,0 +1,173 @@
+#pragma once
+
+#include "cstr_hash_map.h"
+
+// cstr_hash_map_view.h
+
+// Read-only view over a file written by cstr_hash_map::save.
+// open() maps the file and checks the header; find then reads the mapped buckets,
+// entries and string pool directly. Nothing is copied or rebuilt, so opening a large table
+// costs a few system calls and each lookup faults in only the pages it touches.
+template<typename V>
+class cstr_hash_map_view {
+	static_assert(std::is_trivially_copyable<V>::value, "cstr_hash_map_view needs a trivially copyable V");
+
+public:
+	typedef cstr_snapshot_entry<V> Entry;
+
+private:
+	const char* _base;
+	uint64_t _bytes;
+	uint64_t _mask;
+	size_t _size;
+	const uint64_t* _starts;
+	const Entry* _entries;
+	const char* _strings;
+	uint64_t _pool_size;
+
+	// [offset, offset + length) lies inside the mapped file, without overflowing.
+	inline bool in_file(uint64_t offset, uint64_t length) const noexcept {
+		return offset <= _bytes && length <= _bytes - offset;
+	}
+
+	// The key and the byte after it (its NUL) lie inside the string pool. key and length are 32 bit, no overflow.
+	inline bool in_pool(const Entry& entry) const noexcept {
+		return static_cast<uint64_t>(entry.key) + entry.length < _pool_size;
+	}
+
+	// O(1) checks only, so open() touches the header page and the two ends of the bucket starts.
+	// What varies per bucket or entry (run bounds, key offsets) is checked where a lookup reads it,
+	// on pages that lookup faults in anyway.
+	bool validate() noexcept {
+		if (_bytes < sizeof(cstr_snapshot_header)) return false;
+		const cstr_snapshot_header* header = reinterpret_cast<const cstr_snapshot_header*>(_base);
+		if (header->magic != cstr_snapshot_header::MAGIC || header->version != cstr_snapshot_header::VERSION) return false;
+		if (header->word_size != sizeof(size_t) || header->value_size != sizeof(V)) return false;
+		if (header->file_size != _bytes) return false;
+
+		// Sections: in order, aligned, inside the file. Counts are bounded by the file size before any multiply.
+		const uint64_t buckets = header->bucket_count;
+		const uint64_t size = header->size;
+		if (buckets == 0 || (buckets & (buckets - 1)) != 0 || buckets >= _bytes / sizeof(uint64_t)) return false;
+		if (size > _bytes / sizeof(Entry)) return false;
+		if (header->buckets < sizeof(cstr_snapshot_header) || header->buckets % alignof(uint64_t) != 0) return false;
+		if (header->entries % alignof(Entry) != 0) return false;
+		if (!in_file(header->buckets, sizeof(uint64_t) * (buckets + 1))) return false;
+		if (header->entries < header->buckets + sizeof(uint64_t) * (buckets + 1)) return false;
+		if (!in_file(header->entries, sizeof(Entry) * size)) return false;
+		if (header->strings < header->entries + sizeof(Entry) * size || header->strings > _bytes) return false;
+
+		const uint64_t* starts = reinterpret_cast<const uint64_t*>(_base + header->buckets);
+		const Entry* entries = reinterpret_cast<const Entry*>(_base + header->entries);
+		const char* strings = _base + header->strings;
+		if (starts[0] != 0 || starts[buckets] != size) return false;
+
+		_mask = buckets - 1;
+		_size = static_cast<size_t>(size);
+		_starts = starts;
+		_entries = entries;
+		_strings = strings;
+		_pool_size = _bytes - header->strings;
+		return true;
+	}
+
+public:
+	cstr_hash_map_view() noexcept
+		: _base(nullptr), _bytes(0), _mask(0), _size(0), _starts(nullptr), _entries(nullptr), _strings(nullptr), _pool_size(0) {}
+	explicit cstr_hash_map_view(const char* path) noexcept : cstr_hash_map_view() { open(path); }
+	~cstr_hash_map_view() noexcept { close(); }
+
+	cstr_hash_map_view(const cstr_hash_map_view&) = delete;
+	cstr_hash_map_view& operator=(const cstr_hash_map_view&) = delete;
+	cstr_hash_map_view(cstr_hash_map_view&&) = delete;
+	cstr_hash_map_view& operator=(cstr_hash_map_view&&) = delete;
+
+	// false if the file is missing, cannot be mapped, was written for another V / word size,
+	// or is truncated or corrupt.
+	bool open(const char* path) noexcept {
+		close();
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (!mapping) return false;
+		// The view keeps the mapping object alive after its handle is closed
+		_base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		CloseHandle(mapping);
+		if (!_base) return false;
+		_bytes = static_cast<uint64_t>(file_size.QuadPart);
+		if (validate()) return true;
+		close();
+		return false;
+	}
+
+	void close() noexcept {
+		if (_base) UnmapViewOfFile(_base);
+		_base = nullptr;
+		_bytes = 0;
+		_mask = 0;
+		_size = 0;
+		_starts = nullptr;
+		_entries = nullptr;
+		_strings = nullptr;
+		_pool_size = 0;
+	}
+
+	inline bool is_open() const noexcept { return _base != nullptr; }
+	inline size_t size() const noexcept { return _size; }
+	inline bool empty() const noexcept { return _size == 0; }
+
+	// hash_value must equal cstr_hash(key), as for cstr_hash_map.
+	// A corrupt bucket run or key offset reads as a miss.
+	const V* find(std::string_view key, size_t hash_value) const noexcept {
+		if (!_base) return nullptr;
+		const size_t bucket = static_cast<size_t>(hash_value & _mask);
+		const uint64_t first = _starts[bucket];
+		const uint64_t last = _starts[bucket + 1];
+		if (first > last || last > _size) return nullptr;
+		for (const Entry* entry = _entries + first; entry != _entries + last; ++entry) {
+			if (entry->hash == hash_value && entry->length == key.size() && in_pool(*entry)
+				&& memcmp(_strings + entry->key, key.data(), key.size()) == 0) {
+				return &entry->value;
+			}
+		}
+		return nullptr;
+	}
+	const V* find(std::string_view key) const noexcept { return find(key, cstr_hash(key)); }
+	const V* find(const char* key) const noexcept { return find(std::string_view(key)); }
+	const V* find(const char* key, size_t hash_value) const noexcept { return find(std::string_view(key), hash_value); }
+
+	bool contains(std::string_view key) const noexcept { return find(key) != nullptr; }
+	bool contains(const char* key) const noexcept { return find(key) != nullptr; }
+
+	// Entries in file order; key(entry) points into the mapped string pool and is NUL-terminated,
+	// or is nullptr for an entry whose key lies outside the pool or lacks its NUL (corrupt file).
+	inline const Entry* begin() const noexcept { return _entries; }
+	inline const Entry* end() const noexcept { return _entries + _size; }
+	inline const char* key(const Entry& entry) const noexcept {
+		if (!in_pool(entry) || _strings[entry.key + entry.length] != '\0') return nullptr;
+		return _strings + entry.key;
+	}
+};
+
+/*
+Features:
+	- Zero-copy read side of cstr_hash_map::save: the file is mapped with CreateFileMapping / MapViewOfFile
+	  and queried in place. Startup cost is O(page faults) instead of rebuilding the table.
+	- Chains are offsets, not pointers: bucket b owns the contiguous entry run [starts[b], starts[b + 1]),
+	  so a lookup is one bucket read and a linear scan of adjacent entries.
+	- Keys live in an inline string pool, so pointers handed out by key() stay valid until close().
+	- The header records magic, version, sizeof(size_t) and sizeof(V); a mismatched file is rejected by open().
+	- A truncated or corrupt file is never read out of bounds: open() rejects bad headers and section
+	  bounds in O(1), and find / key() check the bucket run and key offset they are about to read, so
+	  damage there reads as a miss. Trade-off: a few compares per lookup instead of a scan of every entry at open.
+Usage:
+	map.save("names.bin");                 // once, at build time
+	cstr_hash_map_view<int> names("names.bin");
+	const int* id = names.find(packet_name); // std::string_view or const char*
+*/
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "cstr_hash_map.h"
+
+// cstr_interner.h
+
+// Owning string pool for runtime keys.
+// intern() copies a string into a bump-allocated arena once and returns a pointer
+// that stays valid until clear() or destruction. Equal strings always get the same pointer,
+// so maps keyed by interned pointers hit the a == b fast path of cstr_cmp.
+class cstr_interner {
+private:
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	struct Chunk {
+		Chunk* next;
+		size_t capacity;
+		size_t used;
+		inline char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+	};
+
+	Chunk* _chunks;     // current chunk first
+	size_t _chunk_size;
+	size_t _bytes;      // string bytes handed out, terminators included
+	cstr_hash_map<size_t> _index; // interned pointer -> length, the arena copies are the keys
+
+	char* allocate(size_t bytes) noexcept;
+
+public:
+	explicit cstr_interner(size_t chunk_size = DEFAULT_CHUNK_SIZE, size_t capacity = 64) noexcept;
+	~cstr_interner() noexcept;
+
+	cstr_interner(const cstr_interner&) = delete;
+	cstr_interner& operator=(const cstr_interner&) = delete;
+	cstr_interner(cstr_interner&&) = delete;
+	cstr_interner& operator=(cstr_interner&&) = delete;
+
+	// Stable, NUL-terminated pointer to the pooled copy of str, copying it only the first time.
+	// A view need not be terminated, so a name can be interned straight out of a packet.
+	const char* intern(std::string_view str) noexcept;
+	const char* intern(const char* str) noexcept { return intern(std::string_view(str)); }
+
+	// Pooled pointer for str, or nullptr if it was never interned. Never copies.
+	const char* find(std::string_view str) noexcept;
+	const char* find(const char* str) noexcept { return find(std::string_view(str)); }
+
+	inline bool contains(std::string_view str) noexcept { return find(str) != nullptr; }
+	inline size_t size() const noexcept { return _index.size(); }
+	inline size_t bytes() const noexcept { return _bytes; }
+
+	// Invalidates every pointer returned so far. Keeps the newest chunk for reuse.
+	void clear() noexcept;
+};
+
+/*
+Features:
+	- Arena of malloc'd chunks (64KB by default); strings are never moved or freed one by one.
+	- Deduplication goes through cstr_hash_map itself, hashing each string once.
+	- Oversized strings get a dedicated chunk and do not waste the current one.
+Usage:
+	cstr_interner names;
+	cstr_hash_map<int> map;
+	map[names.intern(buffer)] = 1; // buffer can be reused right after
+*/
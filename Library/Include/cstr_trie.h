@@ -0,0 +1,705 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CSTR_TRIE_SSE2 1
+#else
+#define CSTR_TRIE_SSE2 0
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// cstr_trie.h
+
+inline unsigned int cstr_trie_ctz(unsigned int mask) noexcept {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<unsigned int>(index);
+#else
+	return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+
+// Adaptive radix tree over C-style string keys (Leis et al., "The Adaptive Radix Tree").
+// Inner nodes grow and shrink between 4, 16, 48 and 256 children, and single-child paths
+// are collapsed into a per-node prefix. Key bytes are compared as unsigned, so iteration is
+// in strcmp order. The key's terminating NUL acts as a branch byte, so one key may be a prefix of another.
+// Keys are stored as pointers, exactly like cstr_hash_map: the characters must outlive the trie.
+template<typename V>
+class cstr_trie {
+private:
+	static constexpr uint32_t MAX_PREFIX = 10; // prefix bytes kept inline; longer prefixes are checked at the leaf
+
+	enum NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+	struct Node {
+		uint32_t prefix_len;
+		uint16_t count;
+		NodeType type;
+		unsigned char prefix[MAX_PREFIX];
+		explicit Node(NodeType t) noexcept : prefix_len(0), count(0), type(t), prefix{} {}
+	};
+	struct Node4 : Node {
+		unsigned char keys[4];
+		Node* children[4];
+		Node4() noexcept : Node(NODE4), keys{}, children{} {}
+	};
+	struct Node16 : Node {
+		unsigned char keys[16];
+		Node* children[16];
+		Node16() noexcept : Node(NODE16), keys{}, children{} {}
+	};
+	struct Node48 : Node {
+		unsigned char index[256]; // 0 : no child, otherwise slot + 1
+		Node* children[48];
+		Node48() noexcept : Node(NODE48), index{}, children{} {}
+	};
+	struct Node256 : Node {
+		Node* children[256];
+		Node256() noexcept : Node(NODE256), children{} {}
+	};
+
+	struct Leaf {
+		const char* key;
+		size_t length;
+		V value;
+		template<typename... Args>
+		Leaf(std::string_view k, Args&&... args) noexcept
+			: key(k.data()), length(k.size()), value(std::forward<Args>(args)...) {}
+	};
+
+	// Child slots hold either an inner Node* or a Leaf* tagged with the low bit.
+	inline static bool is_leaf(const Node* node) noexcept { return reinterpret_cast<uintptr_t>(node) & 1; }
+	inline static Leaf* as_leaf(const Node* node) noexcept {
+		return reinterpret_cast<Leaf*>(reinterpret_cast<uintptr_t>(node) & ~static_cast<uintptr_t>(1));
+	}
+	inline static Node* tag(Leaf* leaf) noexcept {
+		return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(leaf) | 1);
+	}
+
+	Node* _root;
+	size_t _size;
+
+	// Byte at depth, the terminating NUL (0) past the end.
+	inline static unsigned char key_at(std::string_view key, size_t depth) noexcept {
+		return depth < key.size() ? static_cast<unsigned char>(key[depth]) : 0;
+	}
+
+	inline static bool leaf_matches(const Leaf* leaf, std::string_view key) noexcept {
+		return leaf->length == key.size() && memcmp(leaf->key, key.data(), key.size()) == 0;
+	}
+
+	inline static bool leaf_is_prefix_of(const Leaf* leaf, std::string_view text) noexcept {
+		return leaf->length <= text.size() && memcmp(leaf->key, text.data(), leaf->length) == 0;
+	}
+
+	inline static bool leaf_is_prefix_of_key(std::string_view prefix, const Leaf* leaf) noexcept {
+		return prefix.size() <= leaf->length && memcmp(leaf->key, prefix.data(), prefix.size()) == 0;
+	}
+
+	inline static uint32_t min_u32(uint32_t a, uint32_t b) noexcept { return a < b ? a : b; }
+
+	// Child search. Node16 compares all 16 key bytes at once with SSE2;
+	// Node48 and Node256 are direct byte-indexed lookups.
+	static Node** find_child(Node* node, unsigned char c) noexcept {
+		switch (node->type) {
+		case NODE4: {
+			Node4* n = static_cast<Node4*>(node);
+			for (uint16_t i = 0; i < n->count; ++i) {
+				if (n->keys[i] == c) return &n->children[i];
+			}
+			return nullptr;
+		}
+		case NODE16: {
+			Node16* n = static_cast<Node16*>(node);
+#if CSTR_TRIE_SSE2
+			const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(c)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+			const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(cmp)) & ((1u << n->count) - 1);
+			return mask ? &n->children[cstr_trie_ctz(mask)] : nullptr;
+#else
+			for (uint16_t i = 0; i < n->count; ++i) {
+				if (n->keys[i] == c) return &n->children[i];
+			}
+			return nullptr;
+#endif
+		}
+		case NODE48: {
+			Node48* n = static_cast<Node48*>(node);
+			return n->index[c] ? &n->children[n->index[c] - 1] : nullptr;
+		}
+		default: {
+			Node256* n = static_cast<Node256*>(node);
+			return n->children[c] ? &n->children[c] : nullptr;
+		}
+		}
+	}
+	inline static Node* const* find_child(const Node* node, unsigned char c) noexcept {
+		return find_child(const_cast<Node*>(node), c);
+	}
+
+	// First slot in the sorted key array whose byte is greater than c.
+	static uint16_t lower_bound16(const Node16* n, unsigned char c) noexcept {
+#if CSTR_TRIE_SSE2
+		const __m128i bias = _mm_set1_epi8(-128); // signed compare on biased bytes = unsigned compare
+		const __m128i cmp = _mm_cmplt_epi8(_mm_xor_si128(_mm_set1_epi8(static_cast<char>(c)), bias),
+			_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)), bias));
+		const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(cmp)) & ((1u << n->count) - 1);
+		return mask ? static_cast<uint16_t>(cstr_trie_ctz(mask)) : n->count;
+#else
+		uint16_t i = 0;
+		while (i < n->count && n->keys[i] < c) ++i;
+		return i;
+#endif
+	}
+
+	static const Leaf* minimum(const Node* node) noexcept {
+		while (!is_leaf(node)) {
+			switch (node->type) {
+			case NODE4: node = static_cast<const Node4*>(node)->children[0]; break;
+			case NODE16: node = static_cast<const Node16*>(node)->children[0]; break;
+			case NODE48: {
+				const Node48* n = static_cast<const Node48*>(node);
+				int i = 0;
+				while (!n->index[i]) ++i;
+				node = n->children[n->index[i] - 1];
+				break;
+			}
+			default: {
+				const Node256* n = static_cast<const Node256*>(node);
+				int i = 0;
+				while (!n->children[i]) ++i;
+				node = n->children[i];
+				break;
+			}
+			}
+		}
+		return as_leaf(node);
+	}
+
+	inline static void copy_header(Node* dst, const Node* src) noexcept {
+		dst->prefix_len = src->prefix_len;
+		dst->count = src->count;
+		memcpy(dst->prefix, src->prefix, min_u32(src->prefix_len, MAX_PREFIX));
+	}
+
+	static void add_child(Node** ref, Node* node, unsigned char c, Node* child) noexcept {
+		switch (node->type) {
+		case NODE4: {
+			Node4* n = static_cast<Node4*>(node);
+			if (n->count < 4) {
+				uint16_t pos = 0;
+				while (pos < n->count && n->keys[pos] < c) ++pos;
+				memmove(n->keys + pos + 1, n->keys + pos, n->count - pos);
+				memmove(n->children + pos + 1, n->children + pos, sizeof(Node*) * (n->count - pos));
+				n->keys[pos] = c;
+				n->children[pos] = child;
+				++n->count;
+				return;
+			}
+			Node16* grown = new Node16();
+			copy_header(grown, n);
+			memcpy(grown->keys, n->keys, 4);
+			memcpy(grown->children, n->children, sizeof(Node*) * 4);
+			*ref = grown;
+			delete n;
+			add_child(ref, grown, c, child);
+			return;
+		}
+		case NODE16: {
+			Node16* n = static_cast<Node16*>(node);
+			if (n->count < 16) {
+				uint16_t pos = lower_bound16(n, c);
+				memmove(n->keys + pos + 1, n->keys + pos, n->count - pos);
+				memmove(n->children + pos + 1, n->children + pos, sizeof(Node*) * (n->count - pos));
+				n->keys[pos] = c;
+				n->children[pos] = child;
+				++n->count;
+				return;
+			}
+			Node48* grown = new Node48();
+			copy_header(grown, n);
+			for (uint16_t i = 0; i < 16; ++i) {
+				grown->index[n->keys[i]] = static_cast<unsigned char>(i + 1);
+				grown->children[i] = n->children[i];
+			}
+			*ref = grown;
+			delete n;
+			add_child(ref, grown, c, child);
+			return;
+		}
+		case NODE48: {
+			Node48* n = static_cast<Node48*>(node);
+			if (n->count < 48) {
+				int pos = 0;
+				while (n->children[pos]) ++pos;
+				n->children[pos] = child;
+				n->index[c] = static_cast<unsigned char>(pos + 1);
+				++n->count;
+				return;
+			}
+			Node256* grown = new Node256();
+			copy_header(grown, n);
+			for (int i = 0; i < 256; ++i) {
+				if (n->index[i]) grown->children[i] = n->children[n->index[i] - 1];
+			}
+			*ref = grown;
+			delete n;
+			add_child(ref, grown, c, child);
+			return;
+		}
+		default: {
+			Node256* n = static_cast<Node256*>(node);
+			n->children[c] = child;
+			++n->count;
+			return;
+		}
+		}
+	}
+
+	// Removes the child at slot (reached through byte c) and shrinks the node when it gets sparse.
+	static void remove_child(Node** ref, Node* node, unsigned char c, Node** slot) noexcept {
+		switch (node->type) {
+		case NODE4: {
+			Node4* n = static_cast<Node4*>(node);
+			const uint16_t pos = static_cast<uint16_t>(slot - n->children);
+			memmove(n->keys + pos, n->keys + pos + 1, n->count - pos - 1);
+			memmove(n->children + pos, n->children + pos + 1, sizeof(Node*) * (n->count - pos - 1));
+			--n->count;
+			if (n->count == 1) {
+				// Collapse: the only child absorbs this node's prefix and branch byte
+				Node* only = n->children[0];
+				if (!is_leaf(only)) {
+					uint32_t prefix = n->prefix_len;
+					if (prefix < MAX_PREFIX) n->prefix[prefix++] = n->keys[0];
+					if (prefix < MAX_PREFIX) {
+						const uint32_t sub = min_u32(only->prefix_len, MAX_PREFIX - prefix);
+						memcpy(n->prefix + prefix, only->prefix, sub);
+						prefix += sub;
+					}
+					memcpy(only->prefix, n->prefix, min_u32(prefix, MAX_PREFIX));
+					only->prefix_len += n->prefix_len + 1;
+				}
+				*ref = only;
+				delete n;
+			}
+			return;
+		}
+		case NODE16: {
+			Node16* n = static_cast<Node16*>(node);
+			const uint16_t pos = static_cast<uint16_t>(slot - n->children);
+			memmove(n->keys + pos, n->keys + pos + 1, n->count - pos - 1);
+			memmove(n->children + pos, n->children + pos + 1, sizeof(Node*) * (n->count - pos - 1));
+			--n->count;
+			if (n->count == 3) {
+				Node4* shrunk = new Node4();
+				copy_header(shrunk, n);
+				memcpy(shrunk->keys, n->keys, 3);
+				memcpy(shrunk->children, n->children, sizeof(Node*) * 3);
+				*ref = shrunk;
+				delete n;
+			}
+			return;
+		}
+		case NODE48: {
+			Node48* n = static_cast<Node48*>(node);
+			n->children[n->index[c] - 1] = nullptr;
+			n->index[c] = 0;
+			--n->count;
+			if (n->count == 12) {
+				Node16* shrunk = new Node16();
+				copy_header(shrunk, n);
+				uint16_t k = 0;
+				for (int i = 0; i < 256; ++i) {
+					if (!n->index[i]) continue;
+					shrunk->keys[k] = static_cast<unsigned char>(i);
+					shrunk->children[k++] = n->children[n->index[i] - 1];
+				}
+				*ref = shrunk;
+				delete n;
+			}
+			return;
+		}
+		default: {
+			Node256* n = static_cast<Node256*>(node);
+			n->children[c] = nullptr;
+			--n->count;
+			if (n->count == 37) {
+				Node48* shrunk = new Node48();
+				copy_header(shrunk, n);
+				int pos = 0;
+				for (int i = 0; i < 256; ++i) {
+					if (!n->children[i]) continue;
+					shrunk->children[pos] = n->children[i];
+					shrunk->index[i] = static_cast<unsigned char>(++pos);
+				}
+				*ref = shrunk;
+				delete n;
+			}
+			return;
+		}
+		}
+	}
+
+	// Optimistic prefix check for lookups: only the inline bytes are compared,
+	// the final leaf compare catches a mismatch past MAX_PREFIX.
+	inline static bool check_prefix(const Node* node, std::string_view key, size_t depth) noexcept {
+		const uint32_t count = min_u32(node->prefix_len, MAX_PREFIX);
+		for (uint32_t i = 0; i < count; ++i) {
+			if (node->prefix[i] != key_at(key, depth + i)) return false;
+		}
+		return true;
+	}
+
+	// Exact mismatch position for inserts, reading past the inline bytes from the subtree's minimum leaf.
+	static uint32_t prefix_mismatch(const Node* node, std::string_view key, size_t depth) noexcept {
+		const uint32_t count = min_u32(node->prefix_len, MAX_PREFIX);
+		uint32_t i = 0;
+		for (; i < count; ++i) {
+			if (node->prefix[i] != key_at(key, depth + i)) return i;
+		}
+		if (node->prefix_len > MAX_PREFIX) {
+			const Leaf* leaf = minimum(node);
+			const std::string_view leaf_key(leaf->key, leaf->length);
+			for (; i < node->prefix_len; ++i) {
+				if (key_at(leaf_key, depth + i) != key_at(key, depth + i)) return i;
+			}
+		}
+		return i;
+	}
+
+	template<typename... Args>
+	std::pair<Leaf*, bool> emplace_leaf(std::string_view key, Args&&... args) noexcept {
+		Node** ref = &_root;
+		size_t depth = 0;
+		for (;;) {
+			Node* node = *ref;
+			if (!node) {
+				Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+				*ref = tag(leaf);
+				++_size;
+				return { leaf, true };
+			}
+
+			if (is_leaf(node)) {
+				Leaf* existing = as_leaf(node);
+				if (leaf_matches(existing, key)) return { existing, false };
+				// Two keys meet: a Node4 holding their common bytes as its prefix
+				const std::string_view other(existing->key, existing->length);
+				size_t common = 0;
+				while (key_at(other, depth + common) == key_at(key, depth + common)) ++common;
+				Node4* split = new Node4();
+				split->prefix_len = static_cast<uint32_t>(common);
+				memcpy(split->prefix, key.data() + depth, min_u32(split->prefix_len, MAX_PREFIX));
+				Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+				add_child(ref, split, key_at(other, depth + common), node);
+				add_child(ref, split, key_at(key, depth + common), tag(leaf));
+				*ref = split;
+				++_size;
+				return { leaf, true };
+			}
+
+			if (node->prefix_len) {
+				const uint32_t diff = prefix_mismatch(node, key, depth);
+				if (diff < node->prefix_len) {
+					// The key leaves the compressed path: split it at diff
+					Node4* split = new Node4();
+					split->prefix_len = diff;
+					memcpy(split->prefix, node->prefix, min_u32(diff, MAX_PREFIX));
+					if (node->prefix_len <= MAX_PREFIX) {
+						add_child(ref, split, node->prefix[diff], node);
+						node->prefix_len -= diff + 1;
+						memmove(node->prefix, node->prefix + diff + 1, min_u32(node->prefix_len, MAX_PREFIX));
+					}
+					else {
+						node->prefix_len -= diff + 1;
+						const Leaf* min_leaf = minimum(node);
+						const std::string_view min_key(min_leaf->key, min_leaf->length);
+						add_child(ref, split, key_at(min_key, depth + diff), node);
+						memcpy(node->prefix, min_key.data() + depth + diff + 1, min_u32(node->prefix_len, MAX_PREFIX));
+					}
+					Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+					add_child(ref, split, key_at(key, depth + diff), tag(leaf));
+					*ref = split;
+					++_size;
+					return { leaf, true };
+				}
+				depth += node->prefix_len;
+			}
+
+			Node** child = find_child(node, key_at(key, depth));
+			if (child) {
+				ref = child;
+				++depth;
+				continue;
+			}
+			Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+			add_child(ref, node, key_at(key, depth), tag(leaf));
+			++_size;
+			return { leaf, true };
+		}
+	}
+
+	const Leaf* find_leaf(std::string_view key) const noexcept {
+		const Node* node = _root;
+		size_t depth = 0;
+		while (node) {
+			if (is_leaf(node)) {
+				const Leaf* leaf = as_leaf(node);
+				return leaf_matches(leaf, key) ? leaf : nullptr;
+			}
+			if (node->prefix_len) {
+				if (!check_prefix(node, key, depth)) return nullptr;
+				depth += node->prefix_len;
+			}
+			Node* const* child = find_child(node, key_at(key, depth));
+			if (!child) return nullptr;
+			node = *child;
+			++depth;
+		}
+		return nullptr;
+	}
+
+	// In-order walk: children in byte order, the NUL branch (shorter key) first.
+	template<typename Func>
+	static void walk(Node* node, Func& func) noexcept {
+		if (is_leaf(node)) {
+			Leaf* leaf = as_leaf(node);
+			func(leaf->key, leaf->value);
+			return;
+		}
+		switch (node->type) {
+		case NODE4: {
+			Node4* n = static_cast<Node4*>(node);
+			for (uint16_t i = 0; i < n->count; ++i) walk(n->children[i], func);
+			return;
+		}
+		case NODE16: {
+			Node16* n = static_cast<Node16*>(node);
+			for (uint16_t i = 0; i < n->count; ++i) walk(n->children[i], func);
+			return;
+		}
+		case NODE48: {
+			Node48* n = static_cast<Node48*>(node);
+			for (int i = 0; i < 256; ++i) {
+				if (n->index[i]) walk(n->children[n->index[i] - 1], func);
+			}
+			return;
+		}
+		default: {
+			Node256* n = static_cast<Node256*>(node);
+			for (int i = 0; i < 256; ++i) {
+				if (n->children[i]) walk(n->children[i], func);
+			}
+			return;
+		}
+		}
+	}
+
+	static void destroy(Node* node) noexcept {
+		if (!node) return;
+		if (is_leaf(node)) {
+			delete as_leaf(node);
+			return;
+		}
+		switch (node->type) {
+		case NODE4: {
+			Node4* n = static_cast<Node4*>(node);
+			for (uint16_t i = 0; i < n->count; ++i) destroy(n->children[i]);
+			delete n;
+			return;
+		}
+		case NODE16: {
+			Node16* n = static_cast<Node16*>(node);
+			for (uint16_t i = 0; i < n->count; ++i) destroy(n->children[i]);
+			delete n;
+			return;
+		}
+		case NODE48: {
+			Node48* n = static_cast<Node48*>(node);
+			for (int i = 0; i < 48; ++i) destroy(n->children[i]);
+			delete n;
+			return;
+		}
+		default: {
+			Node256* n = static_cast<Node256*>(node);
+			for (int i = 0; i < 256; ++i) destroy(n->children[i]);
+			delete n;
+			return;
+		}
+		}
+	}
+
+public:
+	cstr_trie() noexcept : _root(nullptr), _size(0) {}
+	~cstr_trie() noexcept { destroy(_root); }
+
+	cstr_trie(const cstr_trie&) = delete;
+	cstr_trie& operator=(const cstr_trie&) = delete;
+	cstr_trie(cstr_trie&& other) noexcept : _root(other._root), _size(other._size) {
+		other._root = nullptr;
+		other._size = 0;
+	}
+	cstr_trie& operator=(cstr_trie&& other) noexcept {
+		if (this == &other) return *this;
+		destroy(_root);
+		_root = other._root;
+		_size = other._size;
+		other._root = nullptr;
+		other._size = 0;
+		return *this;
+	}
+
+	size_t size() const noexcept { return _size; }
+	bool empty() const noexcept { return _size == 0; }
+
+	// Keys must not contain NUL bytes; the NUL is the end-of-key branch.
+	V* find(std::string_view key) noexcept {
+		const Leaf* leaf = find_leaf(key);
+		return leaf ? &const_cast<Leaf*>(leaf)->value : nullptr;
+	}
+	const V* find(std::string_view key) const noexcept {
+		const Leaf* leaf = find_leaf(key);
+		return leaf ? &leaf->value : nullptr;
+	}
+	V* find(const char* key) noexcept { return find(std::string_view(key)); }
+	const V* find(const char* key) const noexcept { return find(std::string_view(key)); }
+
+	bool contains(std::string_view key) const noexcept { return find_leaf(key) != nullptr; }
+	bool contains(const char* key) const noexcept { return find_leaf(std::string_view(key)) != nullptr; }
+
+	// Inserting overloads take NUL-terminated const char* keys only: the leaf stores the pointer
+	// and for_each hands it back as a C string.
+
+	// Insert or assign.
+	void insert(const char* key, V value) noexcept {
+		std::pair<Leaf*, bool> result = emplace_leaf(std::string_view(key), std::move(value));
+		if (!result.second) result.first->value = std::move(value);
+	}
+
+	template<typename... Args>
+	std::pair<V*, bool> try_emplace(const char* key, Args&&... args) noexcept {
+		std::pair<Leaf*, bool> result = emplace_leaf(std::string_view(key), std::forward<Args>(args)...);
+		return { &result.first->value, result.second };
+	}
+
+	V& operator[](const char* key) noexcept { return emplace_leaf(std::string_view(key)).first->value; }
+
+	bool erase(const char* key) noexcept { return erase(std::string_view(key)); }
+	bool erase(std::string_view key) noexcept {
+		if (!_root) return false;
+		if (is_leaf(_root)) {
+			Leaf* leaf = as_leaf(_root);
+			if (!leaf_matches(leaf, key)) return false;
+			delete leaf;
+			_root = nullptr;
+			--_size;
+			return true;
+		}
+		Node** ref = &_root;
+		size_t depth = 0;
+		for (;;) {
+			Node* node = *ref;
+			if (node->prefix_len) {
+				if (!check_prefix(node, key, depth)) return false;
+				depth += node->prefix_len;
+			}
+			const unsigned char c = key_at(key, depth);
+			Node** child = find_child(node, c);
+			if (!child) return false;
+			if (is_leaf(*child)) {
+				Leaf* leaf = as_leaf(*child);
+				if (!leaf_matches(leaf, key)) return false;
+				remove_child(ref, node, c, child);
+				delete leaf;
+				--_size;
+				return true;
+			}
+			ref = child;
+			++depth;
+		}
+	}
+
+	void clear() noexcept {
+		destroy(_root);
+		_root = nullptr;
+		_size = 0;
+	}
+
+	// Longest stored key that is a prefix of text (command routing: "move" matches "move north").
+	// Returns nullptr if no key is a prefix; matched_length receives the key length.
+	const V* longest_prefix(std::string_view text, size_t* matched_length = nullptr) const noexcept {
+		const Leaf* best = nullptr;
+		const Node* node = _root;
+		size_t depth = 0;
+		while (node) {
+			if (is_leaf(node)) {
+				if (leaf_is_prefix_of(as_leaf(node), text)) best = as_leaf(node);
+				break;
+			}
+			if (node->prefix_len) {
+				if (!check_prefix(node, text, depth)) break;
+				depth += node->prefix_len;
+			}
+			// The NUL branch holds the one key that ends right here
+			Node* const* ends_here = find_child(node, 0);
+			if (ends_here && leaf_is_prefix_of(as_leaf(*ends_here), text)) best = as_leaf(*ends_here);
+			if (depth >= text.size()) break;
+			Node* const* child = find_child(node, static_cast<unsigned char>(text[depth]));
+			if (!child) break;
+			node = *child;
+			++depth;
+		}
+		if (!best) return nullptr;
+		if (matched_length) *matched_length = best->length;
+		return &best->value;
+	}
+
+	// func(const char* key, V& value) for every key, in strcmp order.
+	template<typename Func>
+	void for_each(Func func) noexcept {
+		if (_root) walk(_root, func);
+	}
+
+	// func(const char* key, V& value) for every key starting with prefix, in strcmp order.
+	// Only the subtree under the prefix is visited.
+	template<typename Func>
+	void for_each_prefix(std::string_view prefix, Func func) noexcept {
+		Node* node = _root;
+		size_t depth = 0;
+		while (node) {
+			if (is_leaf(node)) {
+				if (leaf_is_prefix_of_key(prefix, as_leaf(node))) walk(node, func);
+				return;
+			}
+			if (depth + node->prefix_len >= prefix.size()) {
+				// prefix ends inside this node's path: every key below shares the minimum leaf's bytes
+				if (leaf_is_prefix_of_key(prefix, minimum(node))) walk(node, func);
+				return;
+			}
+			if (!check_prefix(node, prefix, depth)) return;
+			depth += node->prefix_len;
+			Node** child = find_child(node, static_cast<unsigned char>(prefix[depth]));
+			if (!child) return;
+			node = *child;
+			++depth;
+		}
+	}
+};
+
+/*
+Features:
+	- Adaptive node sizes (4 / 16 / 48 / 256 children) keep sparse levels small and dense levels one load deep.
+	  Node16 searches its keys with one SSE2 compare; Node48 and Node256 index children by byte directly.
+	- Path compression: single-child chains collapse into a prefix (10 bytes inline, longer ones are
+	  verified at the leaf), so lookup depth follows branching points, not key length.
+	- Exact lookup (find / contains / operator[] / try_emplace / insert / erase) with const char* keys;
+	  find / contains / erase also take std::string_view.
+	- for_each / for_each_prefix visit keys in strcmp order; for_each_prefix("Net::", ...) walks only that subtree.
+	- longest_prefix(text) returns the longest stored key that text starts with, for command routing.
+	- Ownership as cstr_hash_map: key pointers are stored, never copied. Use cstr_interner for transient strings.
+*/
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <exception>
+#include "cstr_hash_map.h"
+
+// dense_cstr_hash_map.h
+
+// cstr_hash_map with a dense layout: entries sit contiguously in one array and the buckets
+// hold entry indices. Chains link entries by index, so rehash rebuilds the buckets with a
+// linear pass over the entries, iteration is a plain array scan regardless of the bucket count,
+// and erase moves the last entry into the hole (swap-remove).
+// Indices are 32 bit, so the map holds at most max_size() = UINT32_MAX entries: past that,
+// insert and try_emplace add nothing (try_emplace returns end()) and operator[] on a new key terminates.
+template<typename V>
+class dense_cstr_hash_map {
+private:
+	static constexpr float LOAD_FACTOR = 0.75f;
+	static constexpr size_t DEFAULT_CAPACITY = 64;
+	static constexpr uint32_t EMPTY = UINT32_MAX; // end of chain / empty bucket
+	static constexpr size_t MAX_SIZE = EMPTY;      // every entry index stays below EMPTY
+
+	struct Entry {
+		const char* key;
+		size_t length;
+		size_t hash;
+		uint32_t next; // index of the next entry in the chain
+		V value;
+
+		template<typename... Args>
+		Entry(std::string_view k, size_t h, uint32_t n, Args&&... args) noexcept
+			: key(k.data()), length(k.size()), hash(h), next(n), value(std::forward<Args>(args)...) {}
+	};
+
+	std::vector<Entry> _entries;
+	uint32_t* _bucket;
+	size_t _capacity; // power of two
+	size_t _mask;
+
+	inline static size_t hash_func(std::string_view key) noexcept { return cstr_hash(key); }
+
+	inline static size_t round_capacity(size_t capacity) noexcept {
+		size_t result = DEFAULT_CAPACITY;
+		while (result < capacity) result <<= 1;
+		return result;
+	}
+
+	inline static bool key_equal(const Entry& entry, std::string_view key, size_t hash_value) noexcept {
+		return entry.hash == hash_value && entry.length == key.size()
+			&& (entry.key == key.data() || memcmp(entry.key, key.data(), key.size()) == 0);
+	}
+
+	inline uint32_t find_index(std::string_view key, size_t hash_value) const noexcept {
+		uint32_t index = _bucket[hash_value & _mask];
+		while (index != EMPTY) {
+			const Entry& entry = _entries[index];
+			if (key_equal(entry, key, hash_value)) return index;
+			index = entry.next;
+		}
+		return EMPTY;
+	}
+
+	// Buckets are rebuilt from the entry array alone, no chain is followed.
+	// If the new array cannot be allocated the old buckets and capacity stay, chains just run longer.
+	void rebuild_buckets(size_t new_capacity) noexcept {
+		uint32_t* bucket = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * new_capacity));
+		if (!bucket) return;
+		free(_bucket);
+		_bucket = bucket;
+		_capacity = new_capacity;
+		_mask = new_capacity - 1;
+		memset(_bucket, 0xFF, sizeof(uint32_t) * _capacity);
+		for (size_t i = 0; i < _entries.size(); ++i) {
+			uint32_t& head = _bucket[_entries[i].hash & _mask];
+			_entries[i].next = head;
+			head = static_cast<uint32_t>(i);
+		}
+	}
+
+	// Points whatever link references entry `from` at `to` instead.
+	inline void relink(uint32_t from, uint32_t to) noexcept {
+		uint32_t* link = &_bucket[_entries[from].hash & _mask];
+		while (*link != from) link = &_entries[*link].next;
+		*link = to;
+	}
+
+	template<typename... Args>
+	std::pair<uint32_t, bool> emplace_index(std::string_view key, size_t hash_value, Args&&... args) noexcept {
+		uint32_t index = find_index(key, hash_value);
+		if (index != EMPTY) return { index, false };
+		if (_entries.size() >= MAX_SIZE) return { EMPTY, false }; // the next index would read as EMPTY
+		if (_entries.size() + 1 > static_cast<size_t>(_capacity * LOAD_FACTOR)) rebuild_buckets(_capacity * 2);
+		index = static_cast<uint32_t>(_entries.size());
+		uint32_t& head = _bucket[hash_value & _mask];
+		_entries.emplace_back(key, hash_value, head, std::forward<Args>(args)...);
+		head = index;
+		return { index, true };
+	}
+
+	inline void insert_index(std::string_view key, size_t hash_value, V value) noexcept {
+		std::pair<uint32_t, bool> result = emplace_index(key, hash_value, std::move(value));
+		if (!result.second && result.first != EMPTY) _entries[result.first].value = std::move(value);
+	}
+
+	inline V& get_or_insert_index(std::string_view key, size_t hash_value) noexcept {
+		const uint32_t index = emplace_index(key, hash_value).first;
+		if (index == EMPTY) std::terminate(); // full: there is no value to return, as with a throw inside noexcept
+		return _entries[index].value;
+	}
+
+public:
+	class iterator {
+	private:
+		Entry* _entry;
+	public:
+		iterator() noexcept : _entry(nullptr) {}
+		explicit iterator(Entry* entry) noexcept : _entry(entry) {}
+
+		const char* key() const noexcept { return _entry->key; }
+		std::string_view key_view() const noexcept { return { _entry->key, _entry->length }; }
+		V& value() noexcept { return _entry->value; }
+		const V& value() const noexcept { return _entry->value; }
+
+		std::pair<const char*, V&> operator*() noexcept { return { _entry->key, _entry->value }; }
+		V* operator->() noexcept { return &(_entry->value); }
+
+		bool operator==(const iterator& other) const noexcept { return _entry == other._entry; }
+		bool operator!=(const iterator& other) const noexcept { return _entry != other._entry; }
+
+		iterator& operator++() noexcept { ++_entry; return *this; }
+		iterator operator++(int) noexcept { iterator temp = *this; ++_entry; return temp; }
+	};
+
+	class const_iterator {
+	private:
+		const Entry* _entry;
+	public:
+		const_iterator() noexcept : _entry(nullptr) {}
+		explicit const_iterator(const Entry* entry) noexcept : _entry(entry) {}
+
+		const char* key() const noexcept { return _entry->key; }
+		std::string_view key_view() const noexcept { return { _entry->key, _entry->length }; }
+		const V& value() const noexcept { return _entry->value; }
+
+		std::pair<const char*, const V&> operator*() const noexcept { return { _entry->key, _entry->value }; }
+
+		bool operator==(const const_iterator& other) const noexcept { return _entry == other._entry; }
+		bool operator!=(const const_iterator& other) const noexcept { return _entry != other._entry; }
+
+		const_iterator& operator++() noexcept { ++_entry; return *this; }
+		const_iterator operator++(int) noexcept { const_iterator temp = *this; ++_entry; return temp; }
+	};
+
+	explicit dense_cstr_hash_map(size_t capacity = DEFAULT_CAPACITY)
+		: _entries(), _bucket(nullptr), _capacity(0), _mask(0)
+	{
+		rebuild_buckets(round_capacity(capacity));
+		if (!_bucket) std::terminate(); // no table to fall back to, as with a bad_alloc inside noexcept
+	}
+	~dense_cstr_hash_map() noexcept { free(_bucket); }
+
+	dense_cstr_hash_map(const dense_cstr_hash_map&) = delete;
+	dense_cstr_hash_map& operator=(const dense_cstr_hash_map&) = delete;
+	dense_cstr_hash_map(dense_cstr_hash_map&&) = delete;
+	dense_cstr_hash_map& operator=(dense_cstr_hash_map&&) = delete;
+
+	size_t size() const noexcept { return _entries.size(); }
+	bool empty() const noexcept { return _entries.empty(); }
+	size_t capacity() const noexcept { return _capacity; }
+	static constexpr size_t max_size() noexcept { return MAX_SIZE; }
+	float load_factor() const noexcept {
+		return static_cast<float>(_entries.size()) / static_cast<float>(_capacity);
+	}
+
+	void reserve(size_t new_capacity) noexcept {
+		_entries.reserve(new_capacity);
+		new_capacity = round_capacity(new_capacity);
+		if (new_capacity > _capacity) rebuild_buckets(new_capacity);
+	}
+
+	// Drops the bucket array back to the smallest power of two that fits the current entries,
+	// for maps that were once large.
+	void shrink_to_fit() noexcept {
+		_entries.shrink_to_fit();
+		size_t new_capacity = DEFAULT_CAPACITY;
+		while (_entries.size() >= static_cast<size_t>(new_capacity * LOAD_FACTOR)) new_capacity <<= 1;
+		if (new_capacity < _capacity) rebuild_buckets(new_capacity);
+	}
+
+	// Iteration visits the entry array in order: insertion order until the first erase.
+	// Any insert may reallocate the array, and erase moves the last entry, so both invalidate iterators.
+	iterator begin() noexcept { return iterator(_entries.data()); }
+	iterator end() noexcept { return iterator(_entries.data() + _entries.size()); }
+	const_iterator begin() const noexcept { return const_iterator(_entries.data()); }
+	const_iterator end() const noexcept { return const_iterator(_entries.data() + _entries.size()); }
+
+	// Overloads taking hash_value skip only the hash rounds (the key is still measured and compared);
+	// hash_value must equal cstr_hash(key).
+	iterator find(const char* key) noexcept { return find(std::string_view(key)); }
+	iterator find(const char* key, size_t hash_value) noexcept { return find(std::string_view(key), hash_value); }
+	iterator find(std::string_view key) noexcept { return find(key, hash_func(key)); }
+	iterator find(std::string_view key, size_t hash_value) noexcept {
+		uint32_t index = find_index(key, hash_value);
+		return index == EMPTY ? end() : iterator(_entries.data() + index);
+	}
+
+	bool contains(const char* key) const noexcept { return contains(std::string_view(key)); }
+	bool contains(std::string_view key) const noexcept { return find_index(key, hash_func(key)) != EMPTY; }
+	bool contains(std::string_view key, size_t hash_value) const noexcept { return find_index(key, hash_value) != EMPTY; }
+
+	// Inserting overloads take NUL-terminated const char* keys only: the entry stores the pointer
+	// and key() hands it back as a C string. Views go through cstr_interner::intern first.
+
+	// Insert or assign, moving value into place.
+	void insert(const char* key, V value) noexcept {
+		const std::string_view view(key);
+		insert_index(view, hash_func(view), std::move(value));
+	}
+	void insert(const char* key, size_t hash_value, V value) noexcept {
+		insert_index(std::string_view(key), hash_value, std::move(value));
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const char* key, Args&&... args) noexcept {
+		const std::string_view view(key);
+		std::pair<uint32_t, bool> result = emplace_index(view, hash_func(view), std::forward<Args>(args)...);
+		if (result.first == EMPTY) return { end(), false };
+		return { iterator(_entries.data() + result.first), result.second };
+	}
+
+	V& operator[](const char* key) noexcept { return get_or_insert(key); }
+	V& get_or_insert(const char* key) noexcept {
+		const std::string_view view(key);
+		return get_or_insert_index(view, hash_func(view));
+	}
+	V& get_or_insert(const char* key, size_t hash_value) noexcept {
+		return get_or_insert_index(std::string_view(key), hash_value);
+	}
+
+	// Swap-remove: the last entry moves into the erased slot and its single incoming link is patched.
+	void erase(const char* key) noexcept { erase(std::string_view(key)); }
+	void erase(std::string_view key) noexcept { erase(key, hash_func(key)); }
+	void erase(std::string_view key, size_t hash_value) noexcept {
+		uint32_t* link = &_bucket[hash_value & _mask];
+		while (*link != EMPTY && !key_equal(_entries[*link], key, hash_value)) link = &_entries[*link].next;
+		if (*link == EMPTY) return;
+
+		const uint32_t index = *link;
+		*link = _entries[index].next;
+		const uint32_t last = static_cast<uint32_t>(_entries.size() - 1);
+		if (index != last) {
+			relink(last, index);
+			_entries[index] = std::move(_entries[last]);
+		}
+		_entries.pop_back();
+	}
+
+	// Keeps the bucket array; shrink_to_fit releases it.
+	void clear() noexcept {
+		_entries.clear();
+		memset(_bucket, 0xFF, sizeof(uint32_t) * _capacity);
+	}
+};
+
+/*
+Features:
+	- Same interface as cstr_hash_map (const char* keys, std::string_view lookups, precomputed hash overloads,
+	  try_emplace, insert, operator[], erase, key() / key_view() / value() iterators).
+	- Entries live in one std::vector; buckets and chains are 32 bit indices into it.
+	  Iteration is a linear scan of size() entries and never touches the bucket array,
+	  so a map that once held millions of keys iterates as fast as a small one.
+	- erase is a swap-remove: O(chain) to unlink, then the last entry takes the hole.
+	- Rehash relinks entries in one pass over the array without chasing pointers.
+	- Limits: at most max_size() = UINT32_MAX entries, enforced on insert; references and iterators
+	  do not survive insert or erase.
+*/
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+// id_hash_map.h
+
+// Murmur3 finalizer: every input bit reaches every output bit, so sequential ids spread
+// over the whole table instead of filling one run.
+inline uint64_t id_hash(uint64_t key) noexcept {
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return key;
+}
+
+// Flat open-addressing map for integer keys (session ids, entity ids).
+// Key and value share one slot, probing is linear, and erase shifts the following run back
+// instead of leaving tombstones, so lookups never pay for past deletes.
+// K{} marks an empty slot; that key itself is kept in one extra slot past the table.
+template<typename K, typename V>
+class id_hash_map {
+	static_assert(std::is_integral<K>::value || std::is_enum<K>::value, "id_hash_map needs an integer or enum key");
+
+private:
+	static constexpr size_t DEFAULT_CAPACITY = 16;
+	static constexpr K EMPTY = K{};
+
+	// value is constructed only while key != EMPTY (or the zero slot is in use).
+	struct Slot {
+		K key;
+		V value;
+	};
+
+	Slot* _slots; // _capacity table slots + 1 slot for the EMPTY key
+	size_t _capacity; // power of two
+	size_t _mask;
+	size_t _size;
+	bool _has_empty_key;
+
+	inline size_t home(K key) const noexcept {
+		return static_cast<size_t>(id_hash(static_cast<uint64_t>(key))) & _mask;
+	}
+
+	// Max load 3/4; linear probing gets long runs past that.
+	inline static bool over_load(size_t size, size_t capacity) noexcept { return size * 4 > capacity * 3; }
+
+	inline static size_t round_capacity(size_t size) noexcept {
+		size_t result = DEFAULT_CAPACITY;
+		while (over_load(size, result)) result <<= 1;
+		return result;
+	}
+
+	// calloc: a zeroed key is EMPTY, so a fresh table needs no init pass.
+	inline static Slot* alloc_slots(size_t capacity) noexcept {
+		return static_cast<Slot*>(calloc(capacity + 1, sizeof(Slot))); // nullptr is ignored like bad_alloc
+	}
+
+	inline Slot* empty_key_slot() const noexcept { return _slots + _capacity; }
+
+	// Table slot holding key, or the empty slot that ends its run.
+	inline Slot* probe(K key) const noexcept {
+		size_t index = home(key);
+		while (_slots[index].key != key && _slots[index].key != EMPTY) index = (index + 1) & _mask;
+		return &_slots[index];
+	}
+
+	inline Slot* find_slot(K key) const noexcept {
+		if (key == EMPTY) return _has_empty_key ? empty_key_slot() : nullptr;
+		Slot* slot = probe(key);
+		return slot->key == EMPTY ? nullptr : slot;
+	}
+
+	// Compiles to nothing for trivially destructible V.
+	void destroy_all() noexcept {
+		for (size_t i = 0; i < _capacity; ++i) {
+			if (_slots[i].key != EMPTY) _slots[i].value.~V();
+		}
+		if (_has_empty_key) empty_key_slot()->value.~V();
+	}
+
+	void rehash(size_t new_capacity) noexcept {
+		Slot* old_slots = _slots;
+		const size_t old_capacity = _capacity;
+		_slots = alloc_slots(new_capacity);
+		_capacity = new_capacity;
+		_mask = new_capacity - 1;
+
+		for (size_t i = 0; i < old_capacity; ++i) {
+			Slot& from = old_slots[i];
+			if (from.key == EMPTY) continue;
+			Slot* to = probe(from.key);
+			to->key = from.key;
+			new (&to->value) V(std::move(from.value));
+			from.value.~V();
+		}
+		if (_has_empty_key) {
+			new (&empty_key_slot()->value) V(std::move(old_slots[old_capacity].value));
+			old_slots[old_capacity].value.~V();
+		}
+		free(old_slots);
+	}
+
+	template<typename... Args>
+	std::pair<Slot*, bool> emplace_slot(K key, Args&&... args) noexcept {
+		if (key == EMPTY) {
+			Slot* slot = empty_key_slot();
+			if (_has_empty_key) return { slot, false };
+			new (&slot->value) V(std::forward<Args>(args)...);
+			_has_empty_key = true;
+			++_size;
+			return { slot, true };
+		}
+		Slot* slot = probe(key);
+		if (slot->key == key) return { slot, false };
+		if (over_load(_size + 1, _capacity)) {
+			rehash(_capacity * 2);
+			slot = probe(key);
+		}
+		slot->key = key;
+		new (&slot->value) V(std::forward<Args>(args)...);
+		++_size;
+		return { slot, true };
+	}
+
+	// Closes the hole at index by pulling back every later entry of the run that may legally
+	// sit there (its home is not between the hole and its current slot).
+	void backward_shift(size_t hole) noexcept {
+		size_t next = (hole + 1) & _mask;
+		while (_slots[next].key != EMPTY) {
+			const size_t next_home = home(_slots[next].key);
+			if (((next - next_home) & _mask) >= ((next - hole) & _mask)) {
+				_slots[hole].key = _slots[next].key;
+				new (&_slots[hole].value) V(std::move(_slots[next].value));
+				_slots[next].value.~V();
+				hole = next;
+			}
+			next = (next + 1) & _mask;
+		}
+		_slots[hole].key = EMPTY;
+	}
+
+	inline void reset_empty() noexcept {
+		_slots = alloc_slots(DEFAULT_CAPACITY);
+		_capacity = DEFAULT_CAPACITY;
+		_mask = DEFAULT_CAPACITY - 1;
+		_size = 0;
+		_has_empty_key = false;
+	}
+
+public:
+	// Slot order: table slots first, then the EMPTY key slot if it is in use; end() is one past it.
+	class iterator {
+	private:
+		Slot* _slot;
+		const id_hash_map* _map;
+		void skip_empty() noexcept {
+			Slot* table_end = _map->_slots + _map->_capacity;
+			while (_slot < table_end && _slot->key == EMPTY) ++_slot;
+			if (_slot == table_end && !_map->_has_empty_key) ++_slot;
+		}
+		friend class id_hash_map;
+	public:
+		iterator() noexcept : _slot(nullptr), _map(nullptr) {}
+		iterator(Slot* slot, const id_hash_map* map) noexcept : _slot(slot), _map(map) {}
+
+		K key() const noexcept { return _slot->key; } // the EMPTY key slot keeps EMPTY in its key field
+		V& value() noexcept { return _slot->value; }
+		const V& value() const noexcept { return _slot->value; }
+
+		std::pair<K, V&> operator*() noexcept { return { _slot->key, _slot->value }; }
+		V* operator->() noexcept { return &(_slot->value); }
+
+		bool operator==(const iterator& other) const noexcept { return _slot == other._slot; }
+		bool operator!=(const iterator& other) const noexcept { return _slot != other._slot; }
+
+		iterator& operator++() noexcept { ++_slot; skip_empty(); return *this; }
+		iterator operator++(int) noexcept { iterator temp = *this; ++(*this); return temp; }
+	};
+
+	class const_iterator {
+	private:
+		const Slot* _slot;
+		const id_hash_map* _map;
+		void skip_empty() noexcept {
+			const Slot* table_end = _map->_slots + _map->_capacity;
+			while (_slot < table_end && _slot->key == EMPTY) ++_slot;
+			if (_slot == table_end && !_map->_has_empty_key) ++_slot;
+		}
+		friend class id_hash_map;
+	public:
+		const_iterator() noexcept : _slot(nullptr), _map(nullptr) {}
+		const_iterator(const Slot* slot, const id_hash_map* map) noexcept : _slot(slot), _map(map) {}
+
+		K key() const noexcept { return _slot->key; }
+		const V& value() const noexcept { return _slot->value; }
+
+		std::pair<K, const V&> operator*() const noexcept { return { _slot->key, _slot->value }; }
+
+		bool operator==(const const_iterator& other) const noexcept { return _slot == other._slot; }
+		bool operator!=(const const_iterator& other) const noexcept { return _slot != other._slot; }
+
+		const_iterator& operator++() noexcept { ++_slot; skip_empty(); return *this; }
+		const_iterator operator++(int) noexcept { const_iterator temp = *this; ++(*this); return temp; }
+	};
+
+	explicit id_hash_map(size_t capacity = DEFAULT_CAPACITY)
+		: _slots(nullptr), _capacity(0), _mask(0), _size(0), _has_empty_key(false)
+	{
+		_capacity = round_capacity(capacity);
+		_mask = _capacity - 1;
+		_slots = alloc_slots(_capacity);
+	}
+
+	~id_hash_map() noexcept {
+		destroy_all();
+		free(_slots);
+	}
+
+	id_hash_map(const id_hash_map&) = delete;
+	id_hash_map& operator=(const id_hash_map&) = delete;
+
+	// The moved-from map is left empty and usable.
+	id_hash_map(id_hash_map&& other) noexcept
+		: _slots(other._slots), _capacity(other._capacity), _mask(other._mask),
+		_size(other._size), _has_empty_key(other._has_empty_key)
+	{
+		other.reset_empty();
+	}
+
+	id_hash_map& operator=(id_hash_map&& other) noexcept {
+		if (this != &other) {
+			destroy_all();
+			free(_slots);
+			_slots = other._slots;
+			_capacity = other._capacity;
+			_mask = other._mask;
+			_size = other._size;
+			_has_empty_key = other._has_empty_key;
+			other.reset_empty();
+		}
+		return *this;
+	}
+
+	size_t size() const noexcept { return _size; }
+	bool empty() const noexcept { return _size == 0; }
+	size_t capacity() const noexcept { return _capacity; }
+	float load_factor() const noexcept {
+		return static_cast<float>(_size) / static_cast<float>(_capacity);
+	}
+
+	// Sizes the table so that count keys fit without a rehash.
+	void reserve(size_t count) noexcept {
+		const size_t new_capacity = round_capacity(count);
+		if (new_capacity > _capacity) rehash(new_capacity);
+	}
+
+	// insert may rehash and erase shifts entries back, so both invalidate iterators.
+	iterator begin() noexcept { iterator it(_slots, this); it.skip_empty(); return it; }
+	iterator end() noexcept { return iterator(_slots + _capacity + 1, this); }
+	const_iterator begin() const noexcept { const_iterator it(_slots, this); it.skip_empty(); return it; }
+	const_iterator end() const noexcept { return const_iterator(_slots + _capacity + 1, this); }
+
+	iterator find(K key) noexcept {
+		Slot* slot = find_slot(key);
+		return slot ? iterator(slot, this) : end();
+	}
+	const_iterator find(K key) const noexcept {
+		const Slot* slot = find_slot(key);
+		return slot ? const_iterator(slot, this) : end();
+	}
+
+	bool contains(K key) const noexcept { return find_slot(key) != nullptr; }
+
+	// Insert or assign, moving value into place.
+	void insert(K key, V value) noexcept {
+		std::pair<Slot*, bool> result = emplace_slot(key, std::move(value));
+		if (!result.second) result.first->value = std::move(value);
+	}
+
+	// Constructs V from args only when key is absent.
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(K key, Args&&... args) noexcept {
+		std::pair<Slot*, bool> result = emplace_slot(key, std::forward<Args>(args)...);
+		return { iterator(result.first, this), result.second };
+	}
+
+	V& operator[](K key) noexcept { return emplace_slot(key).first->value; }
+
+	void erase(K key) noexcept {
+		if (key == EMPTY) {
+			if (!_has_empty_key) return;
+			empty_key_slot()->value.~V();
+			_has_empty_key = false;
+			--_size;
+			return;
+		}
+		Slot* slot = probe(key);
+		if (slot->key == EMPTY) return;
+		slot->value.~V();
+		backward_shift(static_cast<size_t>(slot - _slots));
+		--_size;
+	}
+
+	// Keeps the table; capacity only grows.
+	void clear() noexcept {
+		destroy_all();
+		memset(static_cast<void*>(_slots), 0, sizeof(Slot) * (_capacity + 1));
+		_size = 0;
+		_has_empty_key = false;
+	}
+};
+
+/*
+Features:
+	1. Flat Table
+		- Key and value share one slot in a single calloc'd array; no node allocation per insert.
+		- Capacity is a power of two, the home slot is id_hash(key) & mask.
+
+	2. Linear Probing
+		- A lookup scans forward from the home slot until it finds the key or an empty slot,
+		  which keeps a probe within one or two cache lines at the 3/4 max load.
+
+	3. Backward-Shift Deletion
+		- erase pulls the rest of the run back into the hole; there are no tombstones,
+		  so lookup cost depends on the current keys only, not on how many were erased.
+
+	4. Full Key Range
+		- K{} (0) is the empty-slot marker in the table; a key equal to it lives in one extra slot
+		  after the table, so every id is a valid key.
+
+	5. Interface
+		- find / contains / insert / try_emplace / operator[] / erase / reserve / clear,
+		  key() / value() iterators, move only, same shape as cstr_hash_map.
+*/
@@ -1,101 +1,207 @@
 #pragma once 
 
+#include <functional>
+
 // indexed_heap.h 
 
-template<typename T>
+// Min-heap over integer ids with a position table, so an id's priority can be changed in place.
+// Arity children per node (4 by default): a shallower tree than a binary heap, and the priority
+// sits next to its id in the heap array, so picking the smallest child scans one contiguous group
+// instead of jumping through a separate key table per comparison.
+// Compare orders the priorities: the top is the id whose priority compares before all others, so
+// std::greater<T> makes a max-heap (see max_indexed_heap). It is a template argument, not a virtual
+// call, so the comparison inlines into the sift loops. "smallest", "decrease" and "increase" below
+// are meant in Compare's order.
+template<typename T, int Arity = 4, typename Compare = std::less<T>>
 class indexed_heap {
+    static_assert(Arity >= 2, "indexed_heap needs at least two children per node");
 private:
-    std::vector<int> _heap;
+    struct Entry {
+        T key;
+        int id;
+    };
+
+    // The heap starts at _heap[OFFSET], which puts the children of every node
+    // (Arity * i + 1 .. Arity * i + Arity) at a multiple of Arity in the array.
+    static constexpr size_t OFFSET = Arity - 1;
+
+    std::vector<Entry> _heap;
     std::vector<int> _pos;
-    std::vector<T> _key;
     size_t _size;
+    Compare _before; // _before(a, b) : a is nearer the top than b
+    T _absent;       // what get_priority returns for an id that is not in the heap
 private:
-    void swap_node(int i, int j) noexcept {
-        int id_i = _heap[i];
-        int id_j = _heap[j];
-        _heap[i] = id_j;
-        _heap[j] = id_i;
-        _pos[id_i] = j;
-        _pos[id_j] = i;
+    inline Entry& at(size_t index) noexcept { return _heap[OFFSET + index]; }
+    inline const Entry& at(size_t index) const noexcept { return _heap[OFFSET + index]; }
+
+    inline void place(size_t index, const Entry& entry) noexcept {
+        at(index) = entry;
+        _pos[entry.id] = static_cast<int>(index);
     }
-    void heapify_up(int index) noexcept {
+
+    // Both sifts carry the moving entry in a hole and write it once at the end.
+    void heapify_up(size_t index, Entry entry) noexcept {
         while (index > 0) {
-            int parent = (index - 1) / 2;
-            if (compare(index, parent)) {
-                swap_node(index, parent);
-                index = parent;
-            }
-            else {
-                break;
-            }
+            size_t parent = (index - 1) / Arity;
+            if (!_before(entry.key, at(parent).key)) break;
+            place(index, at(parent));
+            index = parent;
         }
+        place(index, entry);
     }
-    void heapify_down(int index) noexcept {
+    void heapify_down(size_t index, Entry entry) noexcept {
         for (;;) {
-            int left = 2 * index + 1;
-            int right = 2 * index + 2;
-            int smallest = index;
-            if (left < static_cast<int>(_size) && compare(left, smallest))
-                smallest = left;
-            if (right < static_cast<int>(_size) && compare(right, smallest))
-                smallest = right;
-            if (smallest == index) break;
-            swap_node(index, smallest);
+            size_t first = index * Arity + 1;
+            if (first >= _size) break;
+            size_t last = first + Arity < _size ? first + Arity : _size;
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (_before(at(child).key, at(smallest).key)) smallest = child;
+            }
+            if (!_before(at(smallest).key, entry.key)) break;
+            place(index, at(smallest));
             index = smallest;
         }
+        place(index, entry);
+    }
+
+    // Grows the id space geometrically so that id is a valid index of _pos.
+    inline void ensure_id(int id) noexcept {
+        const size_t needed = static_cast<size_t>(id) + 1;
+        if (needed <= _pos.size()) return;
+        size_t new_size = _pos.size() * 2;
+        if (new_size < needed) new_size = needed;
+        _pos.resize(new_size, -1);
     }
 public:
     inline bool compare(int i, int j) const noexcept
-    { return _key[_heap[i]] < _key[_heap[j]]; }
+    { return _before(at(static_cast<size_t>(i)).key, at(static_cast<size_t>(j)).key); }
     inline bool contains(int id) const noexcept
     { return id >= 0 && id < static_cast<int>(_pos.size()) && _pos[id] != -1; }
     inline bool empty() const noexcept { return _size == 0; }
     inline size_t size() const noexcept { return _size; }
-    inline const T& get_priority(int id) const noexcept { return _key[id]; }
+    // Priority of an id in the heap. Any other id (popped, erased, never pushed, out of range)
+    // gets T(): priorities live in the heap entries, so nothing is kept for ids that left.
+    inline const T& get_priority(int id) const noexcept
+    { return contains(id) ? at(static_cast<size_t>(_pos[id])).key : _absent; }
 
-    indexed_heap(size_t capacity) noexcept
-        : _heap(), _pos(), _key(), _size(0)
+    // capacity is the initial id space; push / update / assign grow it past that on demand.
+    indexed_heap(size_t capacity = 0, const Compare& compare = Compare()) noexcept
+        : _heap(), _pos(), _size(0), _before(compare), _absent()
     {
-        _heap.reserve(capacity);
+        _heap.reserve(OFFSET + capacity);
+        _heap.resize(OFFSET);
         _pos.resize(capacity, -1);
-        _key.resize(capacity, T());
     }
     ~indexed_heap() noexcept = default;
 
+    // An id already in the heap only moves up: push never raises a priority (see update).
     void push(int id, T priority) noexcept {
+        ensure_id(id);
         if (_pos[id] != -1) {
             decrease_key(id, priority);
             return;
         }
-        int new_idx = static_cast<int>(_size);
-        _key[id] = priority;
-        _pos[id] = new_idx;
-        _heap.push_back(id);
+        _heap.push_back(Entry{ priority, id });
         ++_size;
-        heapify_up(new_idx);
+        heapify_up(_size - 1, Entry{ priority, id });
     }
 
     void decrease_key(int id, T priority) noexcept {
-        if (_pos[id] == -1) return;
-        if (priority >= _key[id]) return;
-        _key[id] = priority;
-        heapify_up(_pos[id]);
+        if (!contains(id)) return;
+        const size_t index = static_cast<size_t>(_pos[id]);
+        if (!_before(priority, at(index).key)) return;
+        heapify_up(index, Entry{ priority, id });
+    }
+
+    void increase_key(int id, T priority) noexcept {
+        if (!contains(id)) return;
+        const size_t index = static_cast<size_t>(_pos[id]);
+        if (!_before(at(index).key, priority)) return;
+        heapify_down(index, Entry{ priority, id });
+    }
+
+    // Sets the priority of id in either direction, pushing it if absent (timer reschedule).
+    void update(int id, T priority) noexcept {
+        if (!contains(id)) {
+            push(id, priority);
+            return;
+        }
+        const size_t index = static_cast<size_t>(_pos[id]);
+        if (_before(priority, at(index).key)) heapify_up(index, Entry{ priority, id });
+        else heapify_down(index, Entry{ priority, id });
     }
 
+    // Removes id from anywhere in the heap (timer cancel). Returns false if it was not there.
+    bool erase(int id) noexcept {
+        if (!contains(id)) return false;
+        const size_t index = static_cast<size_t>(_pos[id]);
+        _pos[id] = -1;
+        --_size;
+        Entry last = _heap.back();
+        _heap.pop_back();
+        if (index == _size) return true;
+        // The last entry fills the hole and moves whichever way its priority says
+        if (index > 0 && _before(last.key, at((index - 1) / Arity).key)) heapify_up(index, last);
+        else heapify_down(index, last);
+        return true;
+    }
+
+    // Replaces the contents with ids[i] -> priorities[i] and heapifies bottom-up in O(n)
+    // instead of n pushes. A repeated id keeps its smallest priority, as with push.
+    void assign(const std::vector<int>& ids, const std::vector<T>& priorities) noexcept {
+        clear();
+        const size_t count = ids.size() < priorities.size() ? ids.size() : priorities.size();
+        _heap.reserve(OFFSET + count);
+        for (size_t i = 0; i < count; ++i) {
+            const int id = ids[i];
+            ensure_id(id);
+            if (_pos[id] == -1) {
+                _pos[id] = static_cast<int>(_size++);
+                _heap.push_back(Entry{ priorities[i], id });
+            }
+            else if (_before(priorities[i], at(static_cast<size_t>(_pos[id])).key)) {
+                at(static_cast<size_t>(_pos[id])).key = priorities[i];
+            }
+        }
+        if (_size < 2) return;
+        for (size_t index = (_size - 2) / Arity + 1; index-- > 0;) heapify_down(index, at(index));
+    }
+
+    // Empties the heap in O(size); the id space is kept.
+    void clear() noexcept {
+        for (size_t index = 0; index < _size; ++index) _pos[at(index).id] = -1;
+        _heap.resize(OFFSET);
+        _size = 0;
+    }
+
+    // Smallest id without removing it, -1 when empty.
+    inline int top() const noexcept { return _size == 0 ? -1 : at(0).id; }
+    // Priority of top(); the heap must not be empty.
+    inline const T& top_priority() const noexcept { return at(0).key; }
+
     int pop() noexcept {
         if (_size == 0) return -1;
-        int top_id = _heap[0];
+        int top_id = at(0).id;
         _pos[top_id] = -1;
         --_size;
-        if (_size > 0) {
-            _heap[0] = _heap[_size];
-            _pos[_heap[0]] = 0;
-            _heap.pop_back();
-            heapify_down(0);
-        }
-        else {
-            _heap.pop_back();
-        }
+        Entry last = _heap.back();
+        _heap.pop_back();
+        if (_size > 0) heapify_down(0, last);
         return top_id;
     }
+
+    // Pops the smallest id together with its priority. Returns false when empty.
+    bool pop(int& id, T& priority) noexcept {
+        if (_size == 0) return false;
+        priority = at(0).key;
+        id = pop();
+        return true;
+    }
 };
+
+template<typename T, int Arity = 4>
+using min_indexed_heap = indexed_heap<T, Arity, std::less<T>>;
+
+template<typename T, int Arity = 4>
+using max_indexed_heap = indexed_heap<T, Arity, std::greater<T>>;
@@ -1,16 +1,130 @@
 #pragma once
 
+#include <type_traits>
+
 // malloc_vector.h 
 
+// Page level address space calls behind malloc_vector's reserved mode (malloc_vector.cpp):
+// VirtualAlloc MEM_RESERVE / MEM_COMMIT on Windows, mmap PROT_NONE / mprotect elsewhere.
+namespace virtual_memory {
+	size_t page_size() noexcept;
+	void* reserve(size_t bytes) noexcept;            // nullptr on failure; nothing is committed
+	bool commit(void* address, size_t bytes) noexcept;
+	void release(void* address, size_t bytes) noexcept;
+}
+
+// SSE2 linear scans behind malloc_vector::find for arithmetic and pointer elements (malloc_vector.cpp).
+// Each returns the index of the first element equal to value, or count. Integers and pointers
+// compare bit patterns; float / double compare with ==, so -0.0 finds 0.0 and NaN finds nothing.
+namespace simd_find {
+	size_t find(const uint8_t* data, size_t count, uint8_t value) noexcept;
+	size_t find(const uint16_t* data, size_t count, uint16_t value) noexcept;
+	size_t find(const uint32_t* data, size_t count, uint32_t value) noexcept;
+	size_t find(const uint64_t* data, size_t count, uint64_t value) noexcept;
+	size_t find(const float* data, size_t count, float value) noexcept;
+	size_t find(const double* data, size_t count, double value) noexcept;
+
+	template<size_t Size> struct bits;
+	template<> struct bits<1> { typedef uint8_t type; };
+	template<> struct bits<2> { typedef uint16_t type; };
+	template<> struct bits<4> { typedef uint32_t type; };
+	template<> struct bits<8> { typedef uint64_t type; };
+}
+
+// Selects the reserved mode constructor: malloc_vector<T> v(reserve_virtual, max_capacity);
+struct reserve_virtual_t { explicit constexpr reserve_virtual_t() = default; };
+inline constexpr reserve_virtual_t reserve_virtual{};
+
 template<typename T>
 class malloc_vector {
 private:
 	T* _data;
 	size_t _size;
 	size_t _capacity;
+	size_t _reserved; // reserved mode: address space for this many elements; 0 : malloc mode
+	T* _buffer;       // small_malloc_vector's inline storage, never freed; nullptr otherwise
+
+	typedef std::is_trivially_copyable<T> trivially_copyable;
+
+	T* reallocate(size_t capacity, std::true_type /* trivially copyable */) noexcept;
+	T* reallocate(size_t capacity, std::false_type) noexcept;
+	bool commit(size_t capacity) noexcept;
+
+	// Makes room for count elements in total; false if the allocation failed.
+	inline bool ensure(size_t count) noexcept {
+		if (count > _capacity) {
+			const size_t grown = grown_capacity();
+			reserve(count > grown ? count : grown);
+		}
+		return count <= _capacity;
+	}
+
+	// Overlapping moves: memmove for trivially copyable T, otherwise assignment in a safe direction.
+	static void move_elements(T* dst, const T* src, size_t count, std::true_type) noexcept {
+		if (count != 0) memmove(dst, src, sizeof(T) * count);
+	}
+	static void move_elements(T* dst, const T* src, size_t count, std::false_type) noexcept {
+		if (dst < src) {
+			for (size_t i = 0; i < count; ++i) dst[i] = src[i];
+		}
+		else {
+			for (size_t i = count; i-- > 0;) dst[i] = src[i];
+		}
+	}
+
+	// memset when every byte of value is the same (zero, all ones, any single byte T).
+	static void fill_elements(T* dst, size_t count, const T& value, std::true_type) noexcept {
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+		size_t same = 1;
+		while (same < sizeof(T) && bytes[same] == bytes[0]) ++same;
+		if (same == sizeof(T)) memset(dst, bytes[0], sizeof(T) * count);
+		else for (size_t i = 0; i < count; ++i) dst[i] = value;
+	}
+	static void fill_elements(T* dst, size_t count, const T& value, std::false_type) noexcept {
+		for (size_t i = 0; i < count; ++i) dst[i] = value;
+	}
+
+	// find() strategy: 1 : SIMD over the bit pattern (integers, pointers), 2 : SIMD float / double,
+	// 0 : operator== loop (everything else).
+	typedef std::integral_constant<int,
+		std::is_same<T, float>::value || std::is_same<T, double>::value ? 2
+		: (std::is_integral<T>::value || std::is_pointer<T>::value)
+			&& (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) ? 1
+		: 0> find_strategy;
+
+	size_t find_index(const T& value, std::integral_constant<int, 0>) const noexcept {
+		for (size_t i = 0; i < _size; ++i) {
+			if (_data[i] == value) return i;
+		}
+		return _size;
+	}
+	size_t find_index(const T& value, std::integral_constant<int, 1>) const noexcept {
+		typedef typename simd_find::bits<sizeof(T)>::type Bits;
+		Bits pattern;
+		memcpy(&pattern, &value, sizeof(T));
+		return simd_find::find(reinterpret_cast<const Bits*>(_data), _size, pattern);
+	}
+	size_t find_index(const T& value, std::integral_constant<int, 2>) const noexcept {
+		return simd_find::find(_data, _size, value);
+	}
+
+	// Reserved mode grows without copying, so it commits in quarter steps instead of doubling.
+	inline size_t grown_capacity() const noexcept {
+		if (_reserved != 0) return _capacity + (_capacity / 4 > 16 ? _capacity / 4 : 16);
+		return _capacity > 0 ? _capacity * 2 : 4;
+	}
+
+protected:
+	// small_malloc_vector: starts on its inline buffer and moves to malloc once that is full.
+	malloc_vector(T* buffer, size_t capacity) noexcept;
 
 public:
 	malloc_vector(size_t capacity = 4);
+	// Reserves address space for max_capacity elements and commits pages as the vector grows,
+	// so elements never move: data() and element pointers stay valid for the vector's lifetime.
+	// Growth past max_capacity fails like a failed malloc. If the reservation itself fails the
+	// vector falls back to malloc mode (reserved_capacity() == 0).
+	malloc_vector(reserve_virtual_t, size_t max_capacity) noexcept;
 	~malloc_vector() noexcept;
 	malloc_vector(const malloc_vector&) = delete;
 	malloc_vector& operator=(const malloc_vector&) = delete;
@@ -54,12 +168,20 @@ public:
 	iterator erase(iterator pos) noexcept; 
 	iterator insert(iterator pos, const T& value) noexcept; 
 
+	// Range operations take [first, last) as pointers, e.g. another container's data().
+	// The range may come from this vector.
+	void append(const T* first, const T* last) noexcept;
+	iterator insert(iterator pos, const T* first, const T* last) noexcept;
+	iterator erase(iterator first, iterator last) noexcept;
+
 	inline bool empty() const noexcept { return _size == 0; }
 	inline size_t size() const noexcept { return _size; }
 	inline size_t capacity() const noexcept { return _capacity; }
+	inline size_t reserved_capacity() const noexcept { return _reserved; }
 
 	void reserve(size_t capacity) noexcept; 
 	void resize(size_t size) noexcept; 
+	void resize(size_t size, const T& value) noexcept; // new elements are copies of value
 	void push_back(const T& value) noexcept;
 	// void emplace_back(const T& value) noexcept; // can not use, as new operator should NOT be used 
 
@@ -80,27 +202,76 @@ public:
 
 template<typename T>
 malloc_vector<T>::malloc_vector(size_t capacity)
-	: _data(nullptr), _size(0), _capacity(0) {
+	: _data(nullptr), _size(0), _capacity(0), _reserved(0), _buffer(nullptr) {
 	if (capacity > 0) {
 		_data = static_cast<T*>(malloc(sizeof(T) * capacity));
 		if (_data) _capacity = capacity;
 	}
 }
 
+template<typename T>
+malloc_vector<T>::malloc_vector(reserve_virtual_t, size_t max_capacity) noexcept
+	: _data(nullptr), _size(0), _capacity(0), _reserved(0), _buffer(nullptr) {
+	if (max_capacity == 0 || max_capacity > SIZE_MAX / sizeof(T)) return;
+	_data = static_cast<T*>(virtual_memory::reserve(sizeof(T) * max_capacity));
+	if (_data) _reserved = max_capacity;
+}
+
+template<typename T>
+malloc_vector<T>::malloc_vector(T* buffer, size_t capacity) noexcept
+	: _data(buffer), _size(0), _capacity(capacity), _reserved(0), _buffer(buffer) {
+}
+
 template<typename T>
 malloc_vector<T>::~malloc_vector() noexcept {
-	if (_data) free(_data);
+	if (_data == nullptr || _data == _buffer) return;
+	if (_reserved != 0) virtual_memory::release(_data, sizeof(T) * _reserved);
+	else free(_data);
 }
 
+// Trivially copyable elements grow with realloc: the allocator can extend the block in place,
+// and glibc moves large (mmap'd) blocks with mremap instead of copying them.
 template<typename T>
-void malloc_vector<T>::reserve(size_t capacity) noexcept {
-	if (capacity <= _capacity) return;
+T* malloc_vector<T>::reallocate(size_t capacity, std::true_type /* trivially copyable */) noexcept {
+	if (_data == nullptr || _data != _buffer) return static_cast<T*>(realloc(_data, sizeof(T) * capacity));
+	T* new_data = static_cast<T*>(malloc(sizeof(T) * capacity)); // leaving the inline buffer
+	if (new_data) memcpy(new_data, _data, sizeof(T) * _size);
+	return new_data;
+}
+
+// Other types are assigned into the new block one by one, the way push_back and insert store them.
+template<typename T>
+T* malloc_vector<T>::reallocate(size_t capacity, std::false_type) noexcept {
 	T* new_data = static_cast<T*>(malloc(sizeof(T) * capacity));
-	if (new_data == nullptr) return;
-	if (_data) {
-		memcpy(new_data, _data, sizeof(T) * _size);
-		free(_data);
+	if (new_data == nullptr) return nullptr;
+	for (size_t i = 0; i < _size; ++i) new_data[i] = _data[i];
+	if (_data && _data != _buffer) free(_data);
+	return new_data;
+}
+
+// Commits the pages that hold elements [_capacity, capacity) of the reserved range.
+template<typename T>
+bool malloc_vector<T>::commit(size_t capacity) noexcept {
+	const size_t page = virtual_memory::page_size();
+	const size_t from = sizeof(T) * _capacity / page * page;
+	size_t to = (sizeof(T) * capacity + page - 1) / page * page;
+	const size_t limit = (sizeof(T) * _reserved + page - 1) / page * page;
+	if (to > limit) to = limit;
+	if (!virtual_memory::commit(reinterpret_cast<char*>(_data) + from, to - from)) return false;
+	_capacity = to / sizeof(T) < _reserved ? to / sizeof(T) : _reserved;
+	return true;
+}
+
+template<typename T>
+void malloc_vector<T>::reserve(size_t capacity) noexcept {
+	if (_reserved != 0) {
+		if (capacity > _reserved) capacity = _reserved;
+		if (capacity > _capacity) commit(capacity);
+		return;
 	}
+	if (capacity <= _capacity) return;
+	T* new_data = reallocate(capacity, trivially_copyable());
+	if (new_data == nullptr) return; // the old block is untouched
 	_data = new_data;
 	_capacity = capacity;
 }
@@ -118,23 +289,31 @@ void malloc_vector<T>::resize(size_t size) noexcept {
 template<typename T>
 void malloc_vector<T>::push_back(const T& value) noexcept {
 	if (_size >= _capacity) {
-		size_t new_capacity = _capacity > 0 ? _capacity * 2 : 4;
-		reserve(new_capacity);
+		const T copy = value; // value may be an element that growth moves
+		reserve(grown_capacity());
+		if (_size < _capacity) {
+			_data[_size] = copy;
+			_size++;
+		}
+		return;
 	}
-	if (_size < _capacity) {
-		_data[_size] = value;
-		_size++;
+	_data[_size] = value;
+	_size++;
+}
+
+template<typename T>
+void malloc_vector<T>::resize(size_t size, const T& value) noexcept {
+	if (size > _size) {
+		const T fill = value; // value may be an element that growth moves
+		if (!ensure(size)) return;
+		fill_elements(_data + _size, size - _size, fill, trivially_copyable());
 	}
+	_size = size;
 }
 
 template<typename T>
 typename malloc_vector<T>::iterator malloc_vector<T>::find(const T& value) noexcept {
-	for (size_t i = 0; i < _size; ++i) {
-		if (_data[i] == value) {
-			return iterator(&_data[i]);
-		}
-	}
-	return end();
+	return iterator(_data + find_index(value, find_strategy()));
 }
 
 template<typename T>
@@ -142,9 +321,7 @@ typename malloc_vector<T>::iterator malloc_vector<T>::erase(iterator pos) noexce
 	T* ptr = pos.operator->();
 	size_t index = static_cast<size_t>(ptr - _data);
 	if (index >= _size) return end();
-	for (size_t i = index; i < _size - 1; ++i) {
-		_data[i] = _data[i + 1];
-	}
+	move_elements(_data + index, _data + index + 1, _size - index - 1, trivially_copyable());
 	--_size;
 	return iterator(&_data[index]);
 }
@@ -154,20 +331,81 @@ typename malloc_vector<T>::iterator malloc_vector<T>::insert(iterator pos, const
 	T* ptr = pos.operator->();
 	size_t index = static_cast<size_t>(ptr - _data);
 	if (index > _size) return end();
-	if (_size >= _capacity) {
-		size_t new_capacity = _capacity > 0 ? _capacity * 2 : 4;
-		reserve(new_capacity);
-	}
-	for (size_t i = _size; i > index; --i) {
-		_data[i] = _data[i - 1];
-	}
-	_data[index] = value;
+	const T copy = value; // value may be an element that growth or the shift moves
+	if (!ensure(_size + 1)) return end();
+	move_elements(_data + index + 1, _data + index, _size - index, trivially_copyable());
+	_data[index] = copy;
 	++_size;
 	return iterator(&_data[index]);
 }
 
+template<typename T>
+void malloc_vector<T>::append(const T* first, const T* last) noexcept {
+	const size_t count = static_cast<size_t>(last - first);
+	if (count == 0) return;
+	const bool inside = first >= _data && first < _data + _size;
+	const size_t offset = inside ? static_cast<size_t>(first - _data) : 0;
+	if (!ensure(_size + count)) return;
+	if (inside) first = _data + offset; // growth may have moved the source
+	move_elements(_data + _size, first, count, trivially_copyable());
+	_size += count;
+}
+
+template<typename T>
+typename malloc_vector<T>::iterator malloc_vector<T>::insert(iterator pos, const T* first, const T* last) noexcept {
+	T* ptr = pos.operator->();
+	const size_t index = static_cast<size_t>(ptr - _data);
+	if (index > _size) return end();
+	const size_t count = static_cast<size_t>(last - first);
+	if (count == 0) return iterator(ptr);
+	if (first < _data + _size && last > _data) {
+		// The source is part of this vector and the shift below would overwrite it: insert a copy
+		T* copy = static_cast<T*>(malloc(sizeof(T) * count));
+		if (copy == nullptr) return end();
+		move_elements(copy, first, count, trivially_copyable());
+		iterator result = insert(pos, copy, copy + count);
+		free(copy);
+		return result;
+	}
+	if (!ensure(_size + count)) return end();
+	move_elements(_data + index + count, _data + index, _size - index, trivially_copyable());
+	move_elements(_data + index, first, count, trivially_copyable());
+	_size += count;
+	return iterator(&_data[index]);
+}
+
+template<typename T>
+typename malloc_vector<T>::iterator malloc_vector<T>::erase(iterator first, iterator last) noexcept {
+	const size_t from = static_cast<size_t>(first.operator->() - _data);
+	const size_t to = static_cast<size_t>(last.operator->() - _data);
+	if (from > to || to > _size) return end();
+	move_elements(_data + from, _data + to, _size - to, trivially_copyable());
+	_size -= to - from;
+	return iterator(_data + from);
+}
+
+// malloc_vector with room for N elements inside the object: no allocation until the N+1th element,
+// after which it behaves exactly like malloc_vector. Same API (it is a malloc_vector<T>), and like
+// malloc_vector it never calls operator new, so NewTracer can use it.
+template<typename T, size_t N>
+class small_malloc_vector : public malloc_vector<T> {
+	static_assert(N > 0, "small_malloc_vector needs at least one inline element");
+private:
+	typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type _storage;
+public:
+	small_malloc_vector() noexcept : malloc_vector<T>(reinterpret_cast<T*>(&_storage), N) {}
+	// true while the elements are still in the inline buffer
+	inline bool is_inline() const noexcept {
+		return this->data() == reinterpret_cast<const T*>(&_storage);
+	}
+};
+
 /*
 STL std::vector like dynamic array implementation using malloc/free internally. 
 Goal : operator new / delete replacement for vector-like dynamic array without using new/delete internally. 
 new operator overloads should use malloc_vector to track allocations and avoid infinite recursive new call. 
+Reserved mode (reserve_virtual) : for vectors that may reach gigabytes (trace buffers, allocation records).
+The address range is reserved once and committed page by page, so growth never copies and never moves
+elements; a reader that learns the size through its own synchronization can read data() without a lock.
+	malloc_vector<Record> trace(reserve_virtual, 1ull << 28); // 256M records of address space
 */
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include "WinMutex.h"
+
+// multi_queue.h
+
+// Relaxed concurrent priority queue (Rihani, Sanders, Dementiev: "MultiQueues").
+// Instead of one heap behind one lock, keeps relaxation * thread_count small heaps, each with its own lock.
+// push locks a random heap; try_pop peeks at the cached tops of two random heaps without locking
+// and pops from the better one. Threads rarely meet on the same lock, so throughput scales with cores,
+// in exchange for pop returning an element close to, but not always exactly, the global minimum.
+// A larger relaxation factor means less contention and a looser order.
+template<typename V, typename P = uint64_t>
+class multi_queue {
+private:
+	static constexpr int TRY_LOCK_ATTEMPTS = 8;
+
+	struct Entry {
+		P priority;
+		V value;
+	};
+	struct Later {
+		bool operator()(const Entry& a, const Entry& b) const noexcept { return b.priority < a.priority; }
+	};
+
+	struct Queue {
+		Win::Mutex lock;
+		std::vector<Entry> heap;       // min-heap ordered by Later
+		std::atomic<size_t> size;      // read without the lock by try_pop / size
+		std::atomic<P> top;            // priority of heap.front() while size != 0
+		char pad[64];                  // keeps the next queue's lock off this queue's cache line
+	};
+
+	Queue* _queues;
+	size_t _count;
+
+	// xorshift64* per thread; seeded from the address of the thread's own state.
+	inline static uint32_t next_random() noexcept {
+		thread_local uint64_t state = 0;
+		if (state == 0) state = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&state)) | 1;
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+	}
+	inline Queue& random_queue() noexcept {
+		return _queues[(static_cast<uint64_t>(next_random()) * _count) >> 32];
+	}
+
+	// Called with q.lock held.
+	inline void publish(Queue& q) noexcept {
+		if (!q.heap.empty()) q.top.store(q.heap.front().priority, std::memory_order_relaxed);
+		q.size.store(q.heap.size(), std::memory_order_release);
+	}
+
+public:
+	explicit multi_queue(unsigned int thread_count, unsigned int relaxation = 2) noexcept
+		: _queues(nullptr), _count(0)
+	{
+		_count = static_cast<size_t>(thread_count) * relaxation;
+		if (_count == 0) _count = 1;
+		_queues = new Queue[_count];
+		for (size_t i = 0; i < _count; ++i) {
+			_queues[i].size.store(0, std::memory_order_relaxed);
+			_queues[i].top.store(P(), std::memory_order_relaxed);
+		}
+	}
+	~multi_queue() noexcept { delete[] _queues; }
+
+	multi_queue(const multi_queue&) = delete;
+	multi_queue& operator=(const multi_queue&) = delete;
+	multi_queue(multi_queue&&) = delete;
+	multi_queue& operator=(multi_queue&&) = delete;
+
+	inline size_t queue_count() const noexcept { return _count; }
+
+	// Sum of the per-heap sizes; exact only while no other thread is pushing or popping.
+	size_t size() const noexcept {
+		size_t total = 0;
+		for (size_t i = 0; i < _count; ++i) total += _queues[i].size.load(std::memory_order_relaxed);
+		return total;
+	}
+	inline bool empty() const noexcept { return size() == 0; }
+
+	void push(V value, P priority) noexcept {
+		Queue* q = &random_queue();
+		for (int attempt = 1; !q->lock.TryLock(); ++attempt) {
+			if (attempt == TRY_LOCK_ATTEMPTS) { q->lock.Lock(); break; }
+			q = &random_queue();
+		}
+		q->heap.push_back(Entry{ priority, std::move(value) });
+		std::push_heap(q->heap.begin(), q->heap.end(), Later());
+		publish(*q);
+		q->lock.Unlock();
+	}
+
+	// Pops an element whose priority is among the smallest, choosing the better top of two random heaps.
+	// Returns false only after a sweep finds every heap empty; a push racing with that sweep may be missed.
+	bool try_pop(V& value, P& priority) noexcept {
+		for (;;) {
+			for (size_t attempt = 0; attempt < _count; ++attempt) {
+				Queue& a = random_queue();
+				Queue& b = random_queue();
+				const bool a_empty = a.size.load(std::memory_order_acquire) == 0;
+				const bool b_empty = b.size.load(std::memory_order_acquire) == 0;
+				if (a_empty && b_empty) continue;
+				Queue& q = a_empty ? b : b_empty ? a
+					: (b.top.load(std::memory_order_relaxed) < a.top.load(std::memory_order_relaxed) ? b : a);
+				if (!q.lock.TryLock()) continue;
+				if (q.heap.empty()) {
+					q.lock.Unlock();
+					continue;
+				}
+				std::pop_heap(q.heap.begin(), q.heap.end(), Later());
+				priority = q.heap.back().priority;
+				value = std::move(q.heap.back().value);
+				q.heap.pop_back();
+				publish(q);
+				q.lock.Unlock();
+				return true;
+			}
+			if (empty()) return false;
+		}
+	}
+};
+
+/*
+Features:
+	- relaxation * thread_count heaps, each behind its own Win::Mutex, padded apart.
+	- push: TryLock on random heaps, falling back to a blocking Lock after a few misses.
+	- try_pop: two random heaps, lock-free peek at their cached top priority, pop from the smaller.
+	- Relaxed order: pops come out close to priority order (rank error grows with the heap count),
+	  which suits work scheduling where throughput matters more than exact order.
+Usage:
+	multi_queue<Task*> jobs(worker_count);       // 2 heaps per worker
+	jobs.push(task, deadline);
+	Task* task; uint64_t when;
+	while (jobs.try_pop(task, when)) run(task);
+*/
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "indexed_heap.h"
+
+// pathfinder.h
+
+// 8-connected grid of walkable / blocked cells. Node ids are y * width + x.
+// Diagonal steps cost SQRT2 and may not cut a blocked corner: both orthogonal cells must be walkable.
+// Cells are stored with a one cell blocked border, so neighbour tests never need a bounds check.
+class grid_map {
+public:
+	static constexpr float SQRT2 = 1.41421356f;
+
+private:
+	int _width;
+	int _height;
+	int _stride; // _width + 2
+	std::vector<uint8_t> _cells; // 1 : walkable, border included
+
+public:
+	grid_map(int width, int height, bool walkable = true) noexcept;
+
+	inline int width() const noexcept { return _width; }
+	inline int height() const noexcept { return _height; }
+	inline int node_count() const noexcept { return _width * _height; }
+	inline int node(int x, int y) const noexcept { return y * _width + x; }
+	inline int x_of(int node) const noexcept { return node % _width; }
+	inline int y_of(int node) const noexcept { return node / _width; }
+
+	// Any x, y is accepted; outside the map is blocked.
+	inline bool walkable(int x, int y) const noexcept {
+		return x >= -1 && x <= _width && y >= -1 && y <= _height && _cells[(y + 1) * _stride + x + 1] != 0;
+	}
+	// Same, for x, y at most one cell outside the map (every neighbour of an in-map cell).
+	inline bool walkable_near(int x, int y) const noexcept { return _cells[(y + 1) * _stride + x + 1] != 0; }
+	inline void set_walkable(int x, int y, bool walkable) noexcept {
+		_cells[(y + 1) * _stride + x + 1] = walkable ? 1 : 0;
+	}
+};
+
+// Heuristics take (node, goal) and must not overestimate for the path to be optimal.
+struct zero_heuristic { // turns A* into Dijkstra
+	inline float operator()(int, int) const noexcept { return 0.0f; }
+};
+
+struct octile_heuristic { // exact on an open 8-connected grid
+	int width;
+	explicit octile_heuristic(const grid_map& map) noexcept : width(map.width()) {}
+	inline float operator()(int node, int goal) const noexcept {
+		const int dx = std::abs(node % width - goal % width);
+		const int dy = std::abs(node / width - goal / width);
+		return dx < dy ? (grid_map::SQRT2 - 1.0f) * dx + dy : (grid_map::SQRT2 - 1.0f) * dy + dx;
+	}
+};
+
+struct euclidean_heuristic {
+	int width;
+	explicit euclidean_heuristic(const grid_map& map) noexcept : width(map.width()) {}
+	inline float operator()(int node, int goal) const noexcept {
+		const float dx = static_cast<float>(node % width - goal % width);
+		const float dy = static_cast<float>(node / width - goal / width);
+		return std::sqrt(dx * dx + dy * dy);
+	}
+};
+
+struct manhattan_heuristic { // overestimates diagonal moves: faster, not always the shortest path
+	int width;
+	explicit manhattan_heuristic(const grid_map& map) noexcept : width(map.width()) {}
+	inline float operator()(int node, int goal) const noexcept {
+		return static_cast<float>(std::abs(node % width - goal % width) + std::abs(node / width - goal / width));
+	}
+};
+
+struct graph_edge {
+	int from;
+	int to;
+	float cost;
+};
+
+// Directed graph in compressed sparse row form: the arcs leaving node n are [begin(n), end(n)).
+class search_graph {
+public:
+	struct Arc {
+		int to;
+		float cost;
+	};
+
+private:
+	std::vector<int> _offsets;
+	std::vector<Arc> _arcs;
+
+public:
+	search_graph(int node_count, const std::vector<graph_edge>& edges) noexcept;
+
+	inline int node_count() const noexcept { return static_cast<int>(_offsets.size()) - 1; }
+	inline const Arc* begin(int node) const noexcept { return _arcs.data() + _offsets[node]; }
+	inline const Arc* end(int node) const noexcept { return _arcs.data() + _offsets[node + 1]; }
+};
+
+// Reusable search state: the open set, g scores and parents live here and are kept between queries,
+// so a query allocates nothing once the pathfinder has seen a map of that size.
+// Per node state is validated with a generation stamp instead of being cleared per query.
+// Every query returns the path cost, or -1 when the goal is unreachable, and fills path
+// (start .. goal, both included) when one is given.
+class pathfinder {
+public:
+	static constexpr float NO_PATH = -1.0f;
+
+private:
+	indexed_heap<float> _open;
+	std::vector<float> _g;
+	std::vector<int> _parent;
+	std::vector<uint32_t> _stamp; // _stamp[n] == _query : _g[n] and _parent[n] belong to this query
+	uint32_t _query;
+	size_t _expanded;
+
+	void begin_query(int node_count) noexcept;
+	inline bool seen(int node) const noexcept { return _stamp[node] == _query; }
+	inline void visit(int node, float g, int parent) noexcept {
+		_stamp[node] = _query;
+		_g[node] = g;
+		_parent[node] = parent;
+	}
+	void build_path(int goal, std::vector<int>* path) const noexcept;
+	void build_grid_path(const grid_map& map, int goal, std::vector<int>* path) const noexcept;
+
+	int jump_straight(const grid_map& map, int x, int y, int dx, int dy, int goal) const noexcept;
+	int jump_diagonal(const grid_map& map, int x, int y, int dx, int dy, int goal) const noexcept;
+
+	// Pushes or improves node reached from parent with cost g.
+	template<typename Heuristic>
+	inline void relax(int node, int parent, float g, int goal, const Heuristic& heuristic) noexcept {
+		if (seen(node) && g >= _g[node]) return;
+		visit(node, g, parent);
+		_open.update(node, g + heuristic(node, goal));
+	}
+
+public:
+	explicit pathfinder(size_t node_capacity = 0) noexcept;
+
+	// Nodes taken off the open set by the last query.
+	inline size_t expanded() const noexcept { return _expanded; }
+
+	template<typename Heuristic>
+	float astar(const grid_map& map, int start, int goal, Heuristic heuristic, std::vector<int>* path = nullptr) noexcept {
+		begin_query(map.node_count());
+		if (!map.walkable(map.x_of(start), map.y_of(start)) || !map.walkable(map.x_of(goal), map.y_of(goal))) return NO_PATH;
+		visit(start, 0.0f, -1);
+		_open.push(start, heuristic(start, goal));
+		const int width = map.width();
+		while (!_open.empty()) {
+			const int current = _open.pop();
+			++_expanded;
+			if (current == goal) {
+				build_path(goal, path);
+				return _g[goal];
+			}
+			const int x = current % width;
+			const int y = current / width;
+			const float g = _g[current];
+			const bool right = map.walkable_near(x + 1, y);
+			const bool left = map.walkable_near(x - 1, y);
+			const bool down = map.walkable_near(x, y + 1);
+			const bool up = map.walkable_near(x, y - 1);
+			if (right) relax(current + 1, current, g + 1.0f, goal, heuristic);
+			if (left) relax(current - 1, current, g + 1.0f, goal, heuristic);
+			if (down) relax(current + width, current, g + 1.0f, goal, heuristic);
+			if (up) relax(current - width, current, g + 1.0f, goal, heuristic);
+			if (right && down && map.walkable_near(x + 1, y + 1)) relax(current + width + 1, current, g + grid_map::SQRT2, goal, heuristic);
+			if (left && down && map.walkable_near(x - 1, y + 1)) relax(current + width - 1, current, g + grid_map::SQRT2, goal, heuristic);
+			if (right && up && map.walkable_near(x + 1, y - 1)) relax(current - width + 1, current, g + grid_map::SQRT2, goal, heuristic);
+			if (left && up && map.walkable_near(x - 1, y - 1)) relax(current - width - 1, current, g + grid_map::SQRT2, goal, heuristic);
+		}
+		return NO_PATH;
+	}
+
+	float dijkstra(const grid_map& map, int start, int goal, std::vector<int>* path = nullptr) noexcept {
+		return astar(map, start, goal, zero_heuristic(), path);
+	}
+
+	// Jump point search (Harabor and Grastien) for uniform cost grids: expands only jump points
+	// and returns the same cost as A* with octile_heuristic. path is expanded back to every cell.
+	float jps(const grid_map& map, int start, int goal, std::vector<int>* path = nullptr) noexcept;
+
+	template<typename Heuristic>
+	float astar(const search_graph& graph, int start, int goal, Heuristic heuristic, std::vector<int>* path = nullptr) noexcept {
+		begin_query(graph.node_count());
+		visit(start, 0.0f, -1);
+		_open.push(start, heuristic(start, goal));
+		while (!_open.empty()) {
+			const int current = _open.pop();
+			++_expanded;
+			if (current == goal) {
+				build_path(goal, path);
+				return _g[goal];
+			}
+			const float g = _g[current];
+			for (const search_graph::Arc* arc = graph.begin(current); arc != graph.end(current); ++arc) {
+				relax(arc->to, current, g + arc->cost, goal, heuristic);
+			}
+		}
+		return NO_PATH;
+	}
+
+	float dijkstra(const search_graph& graph, int start, int goal, std::vector<int>* path = nullptr) noexcept {
+		return astar(graph, start, goal, zero_heuristic(), path);
+	}
+};
+
+/*
+Features:
+	- grid_map: 8-connected, no corner cutting, blocked border so neighbour checks skip bounds tests.
+	- search_graph: CSR adjacency built once from an edge list.
+	- pathfinder: A* with any heuristic functor (zero / octile / euclidean / manhattan or a lambda),
+	  Dijkstra, and jump point search on grids. The open set is an indexed_heap with decrease key;
+	  heap, score and parent arrays are reused across queries and invalidated by a generation stamp.
+Usage:
+	grid_map map(256, 256);
+	map.set_walkable(10, 10, false);
+	pathfinder finder;
+	std::vector<int> path;
+	float cost = finder.astar(map, map.node(0, 0), map.node(200, 180), octile_heuristic(map), &path);
+	cost = finder.jps(map, map.node(0, 0), map.node(200, 180), &path);
+*/
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// radix_heap.h
+
+// Number of significant bits in value, 0 for 0.
+inline int radix_heap_bit_width(uint64_t value) noexcept {
+    if (value == 0) return 0;
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index) + 1;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    const unsigned long high = static_cast<unsigned long>(value >> 32);
+    if (high != 0) {
+        _BitScanReverse(&index, high);
+        return static_cast<int>(index) + 33;
+    }
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return static_cast<int>(index) + 1;
+#else
+    return 64 - __builtin_clzll(value);
+#endif
+}
+
+// Monotone priority queue over integer ids for unsigned keys (Ahuja et al. radix heap).
+// Valid when no key is ever pushed below the last popped key, which holds for Dijkstra / A*
+// with non-negative integer costs and for timers keyed by deadline.
+// An entry lives in bucket bit_width(key ^ last): bucket 0 holds keys equal to last, and
+// bucket b keys that first differ from last at bit b - 1. pop takes from bucket 0; when it
+// is empty, the lowest non-empty bucket is scanned once for its minimum, which becomes last,
+// and its entries are redistributed into strictly lower buckets. Each entry can move down at
+// most bit-count times, so push and pop are amortized O(log C) with no key comparisons
+// between entries except the one minimum scan.
+// Same id interface as indexed_heap: push / decrease_key / pop / contains / get_priority.
+template<typename K>
+class radix_heap {
+    static_assert(std::is_unsigned<K>::value, "radix_heap needs an unsigned integer key");
+private:
+    static constexpr int BUCKETS = static_cast<int>(sizeof(K) * 8) + 1;
+
+    struct Entry {
+        K key;
+        int id;
+    };
+    struct Location {
+        int bucket; // -1 : not in the heap
+        int index;
+    };
+
+    std::vector<Entry> _buckets[BUCKETS];
+    std::vector<Location> _loc;
+    K _last;
+    size_t _size;
+    K _absent; // what get_priority returns for an id that is not in the heap
+private:
+    inline int bucket_of(K key) const noexcept {
+        return radix_heap_bit_width(static_cast<uint64_t>(key ^ _last));
+    }
+
+    inline void ensure_id(int id) noexcept {
+        const size_t needed = static_cast<size_t>(id) + 1;
+        if (needed <= _loc.size()) return;
+        size_t new_size = _loc.size() * 2;
+        if (new_size < needed) new_size = needed;
+        _loc.resize(new_size, Location{ -1, 0 });
+    }
+
+    inline void insert_entry(const Entry& entry) noexcept {
+        const int bucket = bucket_of(entry.key);
+        _loc[entry.id] = Location{ bucket, static_cast<int>(_buckets[bucket].size()) };
+        _buckets[bucket].push_back(entry);
+    }
+
+    // Swap-remove inside the bucket; order within a bucket does not matter.
+    inline void remove_entry(const Location& location) noexcept {
+        std::vector<Entry>& bucket = _buckets[location.bucket];
+        const Entry moved = bucket.back();
+        bucket.pop_back();
+        if (static_cast<size_t>(location.index) < bucket.size()) {
+            bucket[location.index] = moved;
+            _loc[moved.id].index = location.index;
+        }
+    }
+
+    // Bucket 0 is empty and the heap is not: advance last to the smallest key and redistribute.
+    void refill() noexcept {
+        int b = 1;
+        while (_buckets[b].empty()) ++b;
+        std::vector<Entry>& bucket = _buckets[b];
+        K smallest = bucket[0].key;
+        for (size_t i = 1; i < bucket.size(); ++i) {
+            if (bucket[i].key < smallest) smallest = bucket[i].key;
+        }
+        _last = smallest;
+        // Every entry of bucket b now lands in a bucket below b, so the loop never appends to it
+        for (size_t i = 0; i < bucket.size(); ++i) insert_entry(bucket[i]);
+        bucket.clear();
+    }
+public:
+    inline bool contains(int id) const noexcept
+    { return id >= 0 && id < static_cast<int>(_loc.size()) && _loc[id].bucket != -1; }
+    inline bool empty() const noexcept { return _size == 0; }
+    inline size_t size() const noexcept { return _size; }
+    // Key of the most recent pop; pushes below it are raised to it.
+    inline K last() const noexcept { return _last; }
+    // Priority of an id in the heap; any other id (popped, erased, never pushed, out of range) gets 0, as in indexed_heap.
+    inline const K& get_priority(int id) const noexcept
+    { return contains(id) ? _buckets[_loc[id].bucket][_loc[id].index].key : _absent; }
+
+    radix_heap(size_t capacity = 0) noexcept
+        : _buckets(), _loc(), _last(0), _size(0), _absent(0)
+    {
+        _loc.resize(capacity, Location{ -1, 0 });
+    }
+    ~radix_heap() noexcept = default;
+
+    // An id already in the heap only moves up, as in indexed_heap.
+    // A key below last() breaks monotonicity and is treated as last().
+    void push(int id, K priority) noexcept {
+        ensure_id(id);
+        if (_loc[id].bucket != -1) {
+            decrease_key(id, priority);
+            return;
+        }
+        if (priority < _last) priority = _last;
+        insert_entry(Entry{ priority, id });
+        ++_size;
+    }
+
+    void decrease_key(int id, K priority) noexcept {
+        if (!contains(id)) return;
+        if (priority < _last) priority = _last;
+        const Location location = _loc[id];
+        if (priority >= _buckets[location.bucket][location.index].key) return;
+        remove_entry(location);
+        insert_entry(Entry{ priority, id });
+    }
+
+    bool erase(int id) noexcept {
+        if (!contains(id)) return false;
+        remove_entry(_loc[id]);
+        _loc[id].bucket = -1;
+        --_size;
+        return true;
+    }
+
+    int pop() noexcept {
+        if (_size == 0) return -1;
+        if (_buckets[0].empty()) refill();
+        const int id = _buckets[0].back().id;
+        _buckets[0].pop_back();
+        _loc[id].bucket = -1;
+        --_size;
+        return id;
+    }
+
+    // Pops the smallest id together with its key. Returns false when empty.
+    bool pop(int& id, K& priority) noexcept {
+        if (_size == 0) return false;
+        id = pop();
+        priority = _last;
+        return true;
+    }
+
+    // Empties the heap and restarts last() at 0; the id space is kept.
+    void clear() noexcept {
+        for (int b = 0; b < BUCKETS; ++b) {
+            for (const Entry& entry : _buckets[b]) _loc[entry.id].bucket = -1;
+            _buckets[b].clear();
+        }
+        _last = 0;
+        _size = 0;
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stdexcept>
+#include "cstr_hash_map.h"
+
+// static_cstr_map.h
+
+constexpr size_t static_cstr_next_pow2(size_t n) noexcept {
+	size_t p = 1;
+	while (p < n) p <<= 1;
+	return p;
+}
+
+template<typename V>
+struct static_cstr_entry {
+	const char* key;
+	V value;
+};
+
+// Read-only map over a fixed key list, built entirely at compile time with a perfect hash.
+// Keys are split into CAPACITY buckets, then each bucket gets a seed that sends all of its keys
+// to distinct free slots (hash and displace). A lookup is one hash, one bucket read,
+// one slot read and a single key compare, with no collisions to walk.
+template<typename V, size_t N>
+class static_cstr_map {
+	static_assert(N > 0, "static_cstr_map needs at least one key");
+
+public:
+	static constexpr size_t CAPACITY = static_cstr_next_pow2(N); // slots, power of two
+	static constexpr size_t BUCKETS = CAPACITY; // power of two too, so both steps are a mask
+	static constexpr uint64_t MAX_SEED = 1u << 20;
+
+private:
+	static_cstr_entry<V> _slots[CAPACITY];
+	// >= 1 : seed for every key of the bucket, < 0 : -(slot + 1) for a single key bucket, 0 : empty bucket
+	long long _disp[BUCKETS];
+
+	static constexpr uint64_t mix(uint64_t h) noexcept {
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	static constexpr size_t bucket_of(size_t hash) noexcept {
+		return static_cast<size_t>(mix(hash)) & (BUCKETS - 1);
+	}
+
+	static constexpr size_t slot_of(size_t hash, uint64_t seed) noexcept {
+		return static_cast<size_t>(mix(hash ^ (seed * 0x9e3779b97f4a7c15ULL))) & (CAPACITY - 1);
+	}
+
+	static constexpr bool cstr_equal(const char* a, const char* b) noexcept {
+		while (*a && *a == *b) { ++a; ++b; }
+		return *a == *b;
+	}
+
+	constexpr void place(size_t slot, const static_cstr_entry<V>& entry) noexcept {
+		_slots[slot].key = entry.key;
+		_slots[slot].value = entry.value;
+	}
+
+public:
+	// Evaluated at compile time when the map is declared constexpr.
+	// Duplicate keys (or two keys with the same cstr_hash) cannot be separated by any seed;
+	// the throw turns that into a compile error.
+	constexpr explicit static_cstr_map(const static_cstr_entry<V>(&entries)[N])
+		: _slots{}, _disp{}
+	{
+		size_t hashes[N] = {};
+		size_t buckets[N] = {};
+		size_t bucket_size[BUCKETS] = {};
+		bool used[CAPACITY] = {};
+		size_t max_size = 0;
+
+		for (size_t i = 0; i < N; ++i) {
+			hashes[i] = cstr_hash(entries[i].key);
+			buckets[i] = bucket_of(hashes[i]);
+			if (++bucket_size[buckets[i]] > max_size) max_size = bucket_size[buckets[i]];
+		}
+
+		// Largest buckets first, while the table is still mostly empty
+		for (size_t size = max_size; size >= 2; --size) {
+			for (size_t b = 0; b < BUCKETS; ++b) {
+				if (bucket_size[b] != size) continue;
+				for (uint64_t seed = 1;; ++seed) {
+					if (seed > MAX_SEED) throw std::logic_error("static_cstr_map: duplicate key or cstr_hash collision");
+					size_t chosen[N] = {};
+					size_t count = 0;
+					bool ok = true;
+					for (size_t i = 0; i < N && ok; ++i) {
+						if (buckets[i] != b) continue;
+						size_t slot = slot_of(hashes[i], seed);
+						if (used[slot]) ok = false;
+						for (size_t c = 0; c < count && ok; ++c) {
+							if (chosen[c] == slot) ok = false;
+						}
+						chosen[count++] = slot;
+					}
+					if (!ok) continue;
+					count = 0;
+					for (size_t i = 0; i < N; ++i) {
+						if (buckets[i] != b) continue;
+						used[chosen[count]] = true;
+						place(chosen[count++], entries[i]);
+					}
+					_disp[b] = static_cast<long long>(seed);
+					break;
+				}
+			}
+		}
+
+		// Single key buckets take any free slot directly
+		size_t free_slot = 0;
+		for (size_t i = 0; i < N; ++i) {
+			if (bucket_size[buckets[i]] != 1) continue;
+			while (used[free_slot]) ++free_slot;
+			used[free_slot] = true;
+			place(free_slot, entries[i]);
+			_disp[buckets[i]] = -static_cast<long long>(free_slot + 1);
+		}
+	}
+
+	inline constexpr size_t size() const noexcept { return N; }
+	inline constexpr size_t capacity() const noexcept { return CAPACITY; }
+
+	// hash_value must equal cstr_hash(key); pass a constexpr hash to skip hashing literal keys.
+	constexpr const V* find(const char* key, size_t hash_value) const noexcept {
+		const long long disp = _disp[bucket_of(hash_value)];
+		const size_t slot = disp < 0 ? static_cast<size_t>(-disp - 1) : slot_of(hash_value, static_cast<uint64_t>(disp));
+		const char* slot_key = _slots[slot].key;
+		return (slot_key && cstr_equal(slot_key, key)) ? &_slots[slot].value : nullptr;
+	}
+	constexpr const V* find(const char* key) const noexcept { return find(key, cstr_hash(key)); }
+
+	constexpr bool contains(const char* key) const noexcept { return find(key) != nullptr; }
+	constexpr bool contains(const char* key, size_t hash_value) const noexcept { return find(key, hash_value) != nullptr; }
+
+	// Value for key, or fallback when the key is not in the table.
+	constexpr V get(const char* key, const V& fallback) const noexcept {
+		const V* value = find(key);
+		return value ? *value : fallback;
+	}
+
+	// Slot order iteration for report / dump code; empty slots have a null key.
+	inline constexpr const static_cstr_entry<V>* slots() const noexcept { return _slots; }
+};
+
+template<typename V, size_t N>
+constexpr static_cstr_map<V, N> make_static_cstr_map(const static_cstr_entry<V>(&entries)[N]) {
+	return static_cstr_map<V, N>(entries);
+}
+
+/*
+Compile-time companion of cstr_hash_map for fixed tables (opcode names, config keys).
+Usage:
+	constexpr auto opcodes = make_static_cstr_map<int>({
+		{ "add", 1 }, { "sub", 2 }, { "mul", 3 },
+	});
+	static_assert(*opcodes.find("sub") == 2, "");
+	const int* op = opcodes.find(name);                       // runtime key
+	const int* mul = opcodes.find("mul", cstr_hash("mul"));   // hash folded at compile time
+Requirements:
+	- V must be a literal type (trivially copyable values are the intended use).
+	- Keys are C-style string literals; the table stores the pointers, not copies.
+*/
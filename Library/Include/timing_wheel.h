@@ -0,0 +1,92 @@
+#pragma once
+
+// timing_wheel.h
+
+// Hierarchical timing wheel for large numbers of timeouts that are mostly cancelled or pushed back
+// before they fire (session idle timeouts, retransmit timers).
+// Time is an integer tick count. LEVELS wheels of SLOTS slots each cover one byte of the deadline:
+// a timer sits on the highest level where its deadline still differs from now, in the slot of that byte.
+// When now reaches the start of an occupied slot, the slot cascades its timers one or more levels down,
+// and a level 0 slot fires when now reaches it. Timers are intrusive doubly linked lists indexed by id,
+// so schedule, reschedule and cancel are O(1), and advance skips straight to the next occupied slot
+// instead of stepping through every tick. Pushing a deadline later leaves the timer where it is and
+// only records the new deadline; the timer is refiled when its old slot comes up.
+class timing_wheel {
+public:
+	static constexpr int LEVELS = 4;
+	static constexpr int SLOT_BITS = 8;
+	static constexpr int SLOTS = 1 << SLOT_BITS;
+
+private:
+	static constexpr int DUE_LIST = LEVELS * SLOTS;    // deadline <= now: fires on the next advance
+	static constexpr int OVERFLOW_LIST = DUE_LIST + 1; // more than LEVELS bytes away from now
+	static constexpr int LIST_COUNT = OVERFLOW_LIST + 1;
+	static constexpr int WORDS = SLOTS / 64;
+
+	struct Timer {
+		uint64_t deadline;
+		int prev;
+		int next;
+		int list; // -1 : not scheduled
+	};
+
+	std::vector<Timer> _timers; // indexed by id
+	int _heads[LIST_COUNT];
+	uint64_t _occupied[LEVELS][WORDS]; // non-empty slots per level
+	uint64_t _now;
+	size_t _size;
+
+	void ensure_id(int id) noexcept;
+	int list_for(uint64_t deadline) const noexcept;
+	void link(int id, int list) noexcept;
+	void unlink(int id) noexcept;
+	void cascade(int list) noexcept;
+	size_t expire(int list, std::vector<int>& expired) noexcept;
+	uint64_t next_event() const noexcept;
+
+public:
+	explicit timing_wheel(uint64_t now = 0, size_t capacity = 0) noexcept;
+	~timing_wheel() noexcept = default;
+
+	timing_wheel(const timing_wheel&) = delete;
+	timing_wheel& operator=(const timing_wheel&) = delete;
+
+	inline uint64_t now() const noexcept { return _now; }
+	inline size_t size() const noexcept { return _size; }
+	inline bool empty() const noexcept { return _size == 0; }
+	inline bool contains(int id) const noexcept
+	{ return id >= 0 && id < static_cast<int>(_timers.size()) && _timers[id].list != -1; }
+	// id must be scheduled (contains(id)).
+	inline uint64_t get_deadline(int id) const noexcept { return _timers[id].deadline; }
+
+	// Schedules id to fire at deadline, replacing any pending deadline of the same id.
+	// A deadline at or before now() fires on the next advance. The id space grows on demand.
+	void schedule(int id, uint64_t deadline) noexcept;
+
+	// Returns false if id was not scheduled.
+	bool cancel(int id) noexcept;
+
+	// Moves now() forward to now and appends every id whose deadline is <= now to expired,
+	// earlier ticks first. Returns the number of ids appended.
+	size_t advance(uint64_t now, std::vector<int>& expired) noexcept;
+
+	// Unschedules everything; now() is kept.
+	void clear() noexcept;
+};
+
+/*
+Features:
+	- O(1) schedule / reschedule / cancel: unlink and relink in an intrusive list, no sift.
+	  A later deadline for a pending timer (keep-alive) is a single store.
+	- 4 levels x 256 slots cover 2^32 ticks ahead of now; anything further waits in an overflow list
+	  that is re-sorted once every 2^32 ticks.
+	- advance(now) jumps from one occupied slot to the next using per-level occupancy bitmaps,
+	  so idle stretches cost nothing and a timer is touched at most once per level it cascades through.
+	- Ids are plain ints like indexed_heap, so callers keep their own id -> session tables.
+Usage:
+	timing_wheel wheel(now_ms);
+	wheel.schedule(session_id, now_ms + 30000);   // (re)arm the idle timeout
+	wheel.cancel(session_id);                      // session closed
+	expired.clear();
+	wheel.advance(now_ms, expired);                // once per frame
+*/
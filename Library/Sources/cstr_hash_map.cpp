@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include "cstr_hash_map.h"
+
+// cstr_hash_map.cpp
+
+namespace {
+	struct parallel_chunk {
+		void (*task)(void*, size_t, size_t);
+		void* context;
+		size_t begin;
+		size_t end;
+	};
+
+	unsigned int __stdcall parallel_chunk_proc(void* param) {
+		const parallel_chunk* chunk = static_cast<const parallel_chunk*>(param);
+		chunk->task(chunk->context, chunk->begin, chunk->end);
+		return 0;
+	}
+}
+
+void cstr_parallel_for(size_t count, size_t min_per_thread, unsigned int thread_count,
+	void (*task)(void*, size_t, size_t), void* context) noexcept {
+	if (thread_count == 0) {
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		thread_count = static_cast<unsigned int>(si.dwNumberOfProcessors);
+	}
+	const size_t max_threads = count / min_per_thread + 1;
+	if (thread_count > max_threads) thread_count = static_cast<unsigned int>(max_threads);
+	if (thread_count <= 1) {
+		task(context, 0, count);
+		return;
+	}
+
+	const size_t per_chunk = (count + thread_count - 1) / thread_count;
+	std::vector<parallel_chunk> chunks(thread_count);
+	std::vector<HANDLE> threads(thread_count, NULL);
+	for (unsigned int t = 1; t < thread_count; ++t) {
+		const size_t begin = per_chunk * t < count ? per_chunk * t : count;
+		const size_t end = begin + per_chunk < count ? begin + per_chunk : count;
+		if (begin == end) break;
+		chunks[t] = parallel_chunk{ task, context, begin, end };
+		const uintptr_t handle = _beginthreadex(nullptr, 0, parallel_chunk_proc, &chunks[t], 0, nullptr);
+		// No thread (resource limits): the calling thread does this chunk itself
+		if (handle == 0) task(context, begin, end);
+		else threads[t] = reinterpret_cast<HANDLE>(handle);
+	}
+	task(context, 0, per_chunk < count ? per_chunk : count);
+	for (HANDLE thread : threads) {
+		if (thread == NULL) continue;
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+	}
+}
@@ -0,0 +1,77 @@
+#include "pch.h"
+
+#include "cstr_interner.h"
+
+// cstr_interner.cpp
+
+cstr_interner::cstr_interner(size_t chunk_size, size_t capacity) noexcept
+	: _chunks(nullptr), _chunk_size(chunk_size), _bytes(0), _index(capacity)
+{
+}
+
+cstr_interner::~cstr_interner() noexcept {
+	while (_chunks) {
+		Chunk* next = _chunks->next;
+		free(_chunks);
+		_chunks = next;
+	}
+}
+
+char* cstr_interner::allocate(size_t bytes) noexcept {
+	if (_chunks && _chunks->capacity - _chunks->used >= bytes) {
+		char* ptr = _chunks->data() + _chunks->used;
+		_chunks->used += bytes;
+		return ptr;
+	}
+
+	// Strings larger than a chunk get a chunk of their own behind the current one,
+	// so the current chunk keeps serving small strings.
+	const size_t capacity = bytes > _chunk_size ? bytes : _chunk_size;
+	Chunk* chunk = static_cast<Chunk*>(malloc(sizeof(Chunk) + capacity));
+	if (!chunk) return nullptr;
+	chunk->capacity = capacity;
+	chunk->used = bytes;
+	if (bytes > _chunk_size && _chunks) {
+		chunk->next = _chunks->next;
+		_chunks->next = chunk;
+	}
+	else {
+		chunk->next = _chunks;
+		_chunks = chunk;
+	}
+	return chunk->data();
+}
+
+const char* cstr_interner::intern(std::string_view str) noexcept {
+	const size_t hash_value = cstr_hash(str);
+	auto it = _index.find(str, hash_value);
+	if (it != _index.end()) return it.key();
+
+	const size_t length = str.size();
+	char* copy = allocate(length + 1);
+	if (!copy) return nullptr;
+	memcpy(copy, str.data(), length);
+	copy[length] = '\0';
+	_bytes += length + 1;
+	_index.insert(copy, hash_value, length);
+	return copy;
+}
+
+const char* cstr_interner::find(std::string_view str) noexcept {
+	auto it = _index.find(str);
+	return it != _index.end() ? it.key() : nullptr;
+}
+
+void cstr_interner::clear() noexcept {
+	_index.clear();
+	if (!_chunks) return;
+	Chunk* chunk = _chunks->next;
+	while (chunk) {
+		Chunk* next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	_chunks->next = nullptr;
+	_chunks->used = 0;
+	_bytes = 0;
+}
@@ -0,0 +1,155 @@
+#include "pch.h"
+
+#include "malloc_vector.h"
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MALLOC_VECTOR_SSE2
+#endif
+
+// malloc_vector.cpp
+
+#if defined(_WIN32)
+
+size_t virtual_memory::page_size() noexcept {
+	static const size_t size = []() {
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		return static_cast<size_t>(si.dwPageSize);
+	}();
+	return size;
+}
+
+void* virtual_memory::reserve(size_t bytes) noexcept {
+	return VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool virtual_memory::commit(void* address, size_t bytes) noexcept {
+	return VirtualAlloc(address, bytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void virtual_memory::release(void* address, size_t) noexcept {
+	VirtualFree(address, 0, MEM_RELEASE);
+}
+
+#else
+
+size_t virtual_memory::page_size() noexcept {
+	static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+// MAP_NORESERVE: the range counts against overcommit only once it is committed and touched.
+void* virtual_memory::reserve(size_t bytes) noexcept {
+	void* address = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return address == MAP_FAILED ? nullptr : address;
+}
+
+bool virtual_memory::commit(void* address, size_t bytes) noexcept {
+	return mprotect(address, bytes, PROT_READ | PROT_WRITE) == 0;
+}
+
+void virtual_memory::release(void* address, size_t bytes) noexcept {
+	munmap(address, bytes);
+}
+
+#endif
+
+// simd_find: each Lanes type compares one 16 byte block against the broadcast value and
+// returns a non-zero mask if any lane matched. The scan tests four blocks per iteration, stops at
+// the first group with a match, and the scalar loop pins down the exact index (and does the tail).
+
+#if defined(MALLOC_VECTOR_SSE2)
+
+struct Lanes8 {
+	__m128i needle;
+	explicit Lanes8(uint8_t value) noexcept : needle(_mm_set1_epi8(static_cast<char>(value))) {}
+	inline __m128i match(const void* p) const noexcept
+	{ return _mm_cmpeq_epi8(_mm_loadu_si128(static_cast<const __m128i*>(p)), needle); }
+};
+
+struct Lanes16 {
+	__m128i needle;
+	explicit Lanes16(uint16_t value) noexcept : needle(_mm_set1_epi16(static_cast<short>(value))) {}
+	inline __m128i match(const void* p) const noexcept
+	{ return _mm_cmpeq_epi16(_mm_loadu_si128(static_cast<const __m128i*>(p)), needle); }
+};
+
+struct Lanes32 {
+	__m128i needle;
+	explicit Lanes32(uint32_t value) noexcept : needle(_mm_set1_epi32(static_cast<int>(value))) {}
+	inline __m128i match(const void* p) const noexcept
+	{ return _mm_cmpeq_epi32(_mm_loadu_si128(static_cast<const __m128i*>(p)), needle); }
+};
+
+// SSE2 has no 64 bit compare: a lane matches when both of its 32 bit halves do.
+struct Lanes64 {
+	__m128i needle;
+	explicit Lanes64(uint64_t value) noexcept
+		: needle(_mm_set_epi32(static_cast<int>(value >> 32), static_cast<int>(value),
+			static_cast<int>(value >> 32), static_cast<int>(value))) {}
+	inline __m128i match(const void* p) const noexcept {
+		const __m128i halves = _mm_cmpeq_epi32(_mm_loadu_si128(static_cast<const __m128i*>(p)), needle);
+		return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+};
+
+struct LanesFloat {
+	__m128 needle;
+	explicit LanesFloat(float value) noexcept : needle(_mm_set1_ps(value)) {}
+	inline __m128i match(const void* p) const noexcept
+	{ return _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(static_cast<const float*>(p)), needle)); }
+};
+
+struct LanesDouble {
+	__m128d needle;
+	explicit LanesDouble(double value) noexcept : needle(_mm_set1_pd(value)) {}
+	inline __m128i match(const void* p) const noexcept
+	{ return _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(static_cast<const double*>(p)), needle)); }
+};
+
+template<typename Lanes, typename U>
+static size_t find_lanes(const U* data, size_t count, U value) noexcept {
+	const size_t per_block = 16 / sizeof(U);
+	const Lanes lanes(value);
+	size_t i = 0;
+	for (; i + 4 * per_block <= count; i += 4 * per_block) {
+		const U* p = data + i;
+		const __m128i any = _mm_or_si128(_mm_or_si128(lanes.match(p), lanes.match(p + per_block)),
+			_mm_or_si128(lanes.match(p + 2 * per_block), lanes.match(p + 3 * per_block)));
+		if (_mm_movemask_epi8(any) != 0) break;
+	}
+	for (; i < count; ++i) {
+		if (data[i] == value) return i;
+	}
+	return count;
+}
+
+size_t simd_find::find(const uint8_t* data, size_t count, uint8_t value) noexcept { return find_lanes<Lanes8>(data, count, value); }
+size_t simd_find::find(const uint16_t* data, size_t count, uint16_t value) noexcept { return find_lanes<Lanes16>(data, count, value); }
+size_t simd_find::find(const uint32_t* data, size_t count, uint32_t value) noexcept { return find_lanes<Lanes32>(data, count, value); }
+size_t simd_find::find(const uint64_t* data, size_t count, uint64_t value) noexcept { return find_lanes<Lanes64>(data, count, value); }
+size_t simd_find::find(const float* data, size_t count, float value) noexcept { return find_lanes<LanesFloat>(data, count, value); }
+size_t simd_find::find(const double* data, size_t count, double value) noexcept { return find_lanes<LanesDouble>(data, count, value); }
+
+#else
+
+template<typename U>
+static size_t find_scalar(const U* data, size_t count, U value) noexcept {
+	for (size_t i = 0; i < count; ++i) {
+		if (data[i] == value) return i;
+	}
+	return count;
+}
+
+size_t simd_find::find(const uint8_t* data, size_t count, uint8_t value) noexcept { return find_scalar(data, count, value); }
+size_t simd_find::find(const uint16_t* data, size_t count, uint16_t value) noexcept { return find_scalar(data, count, value); }
+size_t simd_find::find(const uint32_t* data, size_t count, uint32_t value) noexcept { return find_scalar(data, count, value); }
+size_t simd_find::find(const uint64_t* data, size_t count, uint64_t value) noexcept { return find_scalar(data, count, value); }
+size_t simd_find::find(const float* data, size_t count, float value) noexcept { return find_scalar(data, count, value); }
+size_t simd_find::find(const double* data, size_t count, double value) noexcept { return find_scalar(data, count, value); }
+
+#endif
@@ -0,0 +1,169 @@
+#include "pch.h"
+
+#include "pathfinder.h"
+
+// pathfinder.cpp
+
+grid_map::grid_map(int width, int height, bool walkable) noexcept
+	: _width(width), _height(height), _stride(width + 2), _cells()
+{
+	_cells.resize(static_cast<size_t>(_stride) * (height + 2), 0);
+	if (walkable) {
+		for (int y = 0; y < height; ++y) memset(&_cells[(y + 1) * _stride + 1], 1, width);
+	}
+}
+
+search_graph::search_graph(int node_count, const std::vector<graph_edge>& edges) noexcept
+	: _offsets(node_count + 1, 0), _arcs(edges.size())
+{
+	for (const graph_edge& edge : edges) ++_offsets[edge.from + 1];
+	for (int n = 0; n < node_count; ++n) _offsets[n + 1] += _offsets[n];
+	std::vector<int> fill(_offsets.begin(), _offsets.end() - 1);
+	for (const graph_edge& edge : edges) _arcs[fill[edge.from]++] = Arc{ edge.to, edge.cost };
+}
+
+pathfinder::pathfinder(size_t node_capacity) noexcept
+	: _open(node_capacity), _g(node_capacity), _parent(node_capacity), _stamp(node_capacity, 0), _query(0), _expanded(0)
+{
+}
+
+void pathfinder::begin_query(int node_count) noexcept {
+	const size_t count = static_cast<size_t>(node_count);
+	if (_stamp.size() < count) {
+		_g.resize(count);
+		_parent.resize(count);
+		_stamp.resize(count, 0);
+	}
+	_open.clear();
+	if (++_query == 0) { // wrapped: old stamps could match again
+		std::fill(_stamp.begin(), _stamp.end(), 0);
+		_query = 1;
+	}
+	_expanded = 0;
+}
+
+void pathfinder::build_path(int goal, std::vector<int>* path) const noexcept {
+	if (path == nullptr) return;
+	path->clear();
+	for (int node = goal; node != -1; node = _parent[node]) path->push_back(node);
+	std::reverse(path->begin(), path->end());
+}
+
+// Parents in a jump point search are jump points; the cells between two of them lie on a straight
+// or diagonal line and are filled back in.
+void pathfinder::build_grid_path(const grid_map& map, int goal, std::vector<int>* path) const noexcept {
+	if (path == nullptr) return;
+	path->clear();
+	path->push_back(goal);
+	for (int node = goal; _parent[node] != -1; node = _parent[node]) {
+		const int parent = _parent[node];
+		int x = map.x_of(node);
+		int y = map.y_of(node);
+		const int px = map.x_of(parent);
+		const int py = map.y_of(parent);
+		const int dx = (px > x) - (px < x);
+		const int dy = (py > y) - (py < y);
+		while (x != px || y != py) {
+			x += dx;
+			y += dy;
+			path->push_back(map.node(x, y));
+		}
+	}
+	std::reverse(path->begin(), path->end());
+}
+
+// Scans from (x, y) in a straight line. Stops at the goal, or at a cell with a forced neighbour:
+// a side cell that is open while the side cell one step back is blocked, so paths may turn there.
+int pathfinder::jump_straight(const grid_map& map, int x, int y, int dx, int dy, int goal) const noexcept {
+	for (;; x += dx, y += dy) {
+		if (!map.walkable_near(x, y)) return -1;
+		const int node = map.node(x, y);
+		if (node == goal) return node;
+		if (dx != 0) {
+			if ((map.walkable_near(x, y - 1) && !map.walkable_near(x - dx, y - 1))
+				|| (map.walkable_near(x, y + 1) && !map.walkable_near(x - dx, y + 1))) return node;
+		}
+		else {
+			if ((map.walkable_near(x - 1, y) && !map.walkable_near(x - 1, y - dy))
+				|| (map.walkable_near(x + 1, y) && !map.walkable_near(x + 1, y - dy))) return node;
+		}
+	}
+}
+
+// Scans diagonally from (x, y), which the caller has already stepped into without cutting a corner.
+// Stops where either straight scan along the diagonal's components finds a jump point.
+int pathfinder::jump_diagonal(const grid_map& map, int x, int y, int dx, int dy, int goal) const noexcept {
+	for (;; x += dx, y += dy) {
+		if (!map.walkable_near(x, y)) return -1;
+		const int node = map.node(x, y);
+		if (node == goal) return node;
+		if (jump_straight(map, x + dx, y, dx, 0, goal) != -1 || jump_straight(map, x, y + dy, 0, dy, goal) != -1) return node;
+		if (!map.walkable_near(x + dx, y) || !map.walkable_near(x, y + dy)) return -1;
+	}
+}
+
+float pathfinder::jps(const grid_map& map, int start, int goal, std::vector<int>* path) noexcept {
+	begin_query(map.node_count());
+	if (!map.walkable(map.x_of(start), map.y_of(start)) || !map.walkable(map.x_of(goal), map.y_of(goal))) return NO_PATH;
+	const octile_heuristic heuristic(map);
+	visit(start, 0.0f, -1);
+	_open.push(start, heuristic(start, goal));
+	while (!_open.empty()) {
+		const int current = _open.pop();
+		++_expanded;
+		if (current == goal) {
+			build_grid_path(map, goal, path);
+			return _g[goal];
+		}
+		const int x = map.x_of(current);
+		const int y = map.y_of(current);
+		const float g = _g[current];
+
+		// Pruned directions: the start looks everywhere, other nodes only ahead of the way they were reached
+		int directions[8][2];
+		int count = 0;
+		const int parent = _parent[current];
+		if (parent == -1) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					if (dx != 0 || dy != 0) { directions[count][0] = dx; directions[count][1] = dy; ++count; }
+				}
+			}
+		}
+		else {
+			const int px = map.x_of(parent);
+			const int py = map.y_of(parent);
+			const int dx = (x > px) - (x < px);
+			const int dy = (y > py) - (y < py);
+			if (dx != 0 && dy != 0) {
+				const int list[3][2] = { { dx, 0 }, { 0, dy }, { dx, dy } };
+				for (const auto& d : list) { directions[count][0] = d[0]; directions[count][1] = d[1]; ++count; }
+			}
+			else if (dx != 0) {
+				const int list[5][2] = { { dx, 0 }, { dx, 1 }, { dx, -1 }, { 0, 1 }, { 0, -1 } };
+				for (const auto& d : list) { directions[count][0] = d[0]; directions[count][1] = d[1]; ++count; }
+			}
+			else {
+				const int list[5][2] = { { 0, dy }, { 1, dy }, { -1, dy }, { 1, 0 }, { -1, 0 } };
+				for (const auto& d : list) { directions[count][0] = d[0]; directions[count][1] = d[1]; ++count; }
+			}
+		}
+
+		for (int i = 0; i < count; ++i) {
+			const int dx = directions[i][0];
+			const int dy = directions[i][1];
+			int jump;
+			if (dx != 0 && dy != 0) {
+				if (!map.walkable_near(x + dx, y) || !map.walkable_near(x, y + dy)) continue; // corner
+				jump = jump_diagonal(map, x + dx, y + dy, dx, dy, goal);
+			}
+			else {
+				jump = jump_straight(map, x + dx, y + dy, dx, dy, goal);
+			}
+			if (jump == -1) continue;
+			const int steps = std::max(std::abs(map.x_of(jump) - x), std::abs(map.y_of(jump) - y));
+			relax(jump, current, g + steps * (dx != 0 && dy != 0 ? grid_map::SQRT2 : 1.0f), goal, heuristic);
+		}
+	}
+	return NO_PATH;
+}
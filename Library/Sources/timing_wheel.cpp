@@ -0,0 +1,201 @@
+#include "pch.h"
+
+#include "timing_wheel.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// timing_wheel.cpp
+
+static inline int lowest_bit(uint64_t mask) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return static_cast<int>(index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (static_cast<unsigned long>(mask) != 0) {
+		_BitScanForward(&index, static_cast<unsigned long>(mask));
+		return static_cast<int>(index);
+	}
+	_BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+	return static_cast<int>(index) + 32;
+#else
+	return __builtin_ctzll(mask);
+#endif
+}
+
+static inline int slot_at(uint64_t tick, int level) noexcept {
+	return static_cast<int>((tick >> (level * timing_wheel::SLOT_BITS)) & (timing_wheel::SLOTS - 1));
+}
+
+timing_wheel::timing_wheel(uint64_t now, size_t capacity) noexcept
+	: _timers(), _heads(), _occupied(), _now(now), _size(0)
+{
+	for (int i = 0; i < LIST_COUNT; ++i) _heads[i] = -1;
+	_timers.resize(capacity, Timer{ 0, -1, -1, -1 });
+}
+
+void timing_wheel::ensure_id(int id) noexcept {
+	const size_t needed = static_cast<size_t>(id) + 1;
+	if (needed <= _timers.size()) return;
+	size_t new_size = _timers.size() * 2;
+	if (new_size < needed) new_size = needed;
+	_timers.resize(new_size, Timer{ 0, -1, -1, -1 });
+}
+
+// The highest byte in which deadline and now differ picks the level; that byte picks the slot.
+int timing_wheel::list_for(uint64_t deadline) const noexcept {
+	if (deadline <= _now) return DUE_LIST;
+	const uint64_t diff = deadline ^ _now;
+	for (int level = 0; level < LEVELS; ++level) {
+		if (diff >> ((level + 1) * SLOT_BITS) == 0) return level * SLOTS + slot_at(deadline, level);
+	}
+	return OVERFLOW_LIST;
+}
+
+void timing_wheel::link(int id, int list) noexcept {
+	Timer& timer = _timers[id];
+	timer.list = list;
+	timer.prev = -1;
+	timer.next = _heads[list];
+	if (timer.next != -1) _timers[timer.next].prev = id;
+	_heads[list] = id;
+	if (list < DUE_LIST) {
+		const int slot = list % SLOTS;
+		_occupied[list / SLOTS][slot >> 6] |= 1ULL << (slot & 63);
+	}
+}
+
+void timing_wheel::unlink(int id) noexcept {
+	Timer& timer = _timers[id];
+	if (timer.prev != -1) _timers[timer.prev].next = timer.next;
+	else _heads[timer.list] = timer.next;
+	if (timer.next != -1) _timers[timer.next].prev = timer.prev;
+	if (timer.list < DUE_LIST && _heads[timer.list] == -1) {
+		const int slot = timer.list % SLOTS;
+		_occupied[timer.list / SLOTS][slot >> 6] &= ~(1ULL << (slot & 63));
+	}
+	timer.list = -1;
+}
+
+// Detaches the whole list and files each timer again relative to the new now.
+void timing_wheel::cascade(int list) noexcept {
+	int id = _heads[list];
+	if (id == -1) return;
+	_heads[list] = -1;
+	if (list < DUE_LIST) {
+		const int slot = list % SLOTS;
+		_occupied[list / SLOTS][slot >> 6] &= ~(1ULL << (slot & 63));
+	}
+	while (id != -1) {
+		const int next = _timers[id].next;
+		link(id, list_for(_timers[id].deadline));
+		id = next;
+	}
+}
+
+size_t timing_wheel::expire(int list, std::vector<int>& expired) noexcept {
+	int id = _heads[list];
+	if (id == -1) return 0;
+	_heads[list] = -1;
+	if (list < DUE_LIST) {
+		const int slot = list % SLOTS;
+		_occupied[list / SLOTS][slot >> 6] &= ~(1ULL << (slot & 63));
+	}
+	size_t count = 0;
+	while (id != -1) {
+		const int next = _timers[id].next;
+		if (_timers[id].deadline > _now) {
+			link(id, list_for(_timers[id].deadline)); // pushed back lazily by schedule
+		}
+		else {
+			expired.push_back(id);
+			_timers[id].list = -1;
+			++count;
+		}
+		id = next;
+	}
+	_size -= count;
+	return count;
+}
+
+// Earliest tick after now at which some slot cascades or fires, UINT64_MAX if none.
+// A slot on level k holds deadlines whose byte k is above now's, so only slots past
+// now's slot on each level need to be searched.
+uint64_t timing_wheel::next_event() const noexcept {
+	uint64_t best = UINT64_MAX;
+	for (int level = 0; level < LEVELS; ++level) {
+		const int from = slot_at(_now, level) + 1;
+		for (int word = from >> 6; word < WORDS; ++word) {
+			uint64_t bits = _occupied[level][word];
+			if (word == from >> 6) bits &= ~0ULL << (from & 63);
+			if (bits == 0) continue;
+			const uint64_t slot = static_cast<uint64_t>(word * 64 + lowest_bit(bits));
+			const int shift = level * SLOT_BITS;
+			const int span = shift + SLOT_BITS;
+			const uint64_t tick = ((_now >> span) << span) | (slot << shift);
+			if (tick < best) best = tick;
+			break;
+		}
+	}
+	if (_heads[OVERFLOW_LIST] != -1) {
+		const int span = LEVELS * SLOT_BITS;
+		const uint64_t tick = ((_now >> span) + 1) << span;
+		if (tick < best) best = tick;
+	}
+	return best;
+}
+
+// Pushing a pending deadline later only rewrites it: the timer stays in its earlier slot and is
+// refiled when that slot cascades or fires. Keep-alive style reschedules then cost one store.
+void timing_wheel::schedule(int id, uint64_t deadline) noexcept {
+	ensure_id(id);
+	Timer& timer = _timers[id];
+	if (timer.list != -1) {
+		if (deadline >= timer.deadline) {
+			timer.deadline = deadline;
+			return;
+		}
+		unlink(id);
+	}
+	else {
+		++_size;
+	}
+	timer.deadline = deadline;
+	link(id, list_for(deadline));
+}
+
+bool timing_wheel::cancel(int id) noexcept {
+	if (!contains(id)) return false;
+	unlink(id);
+	--_size;
+	return true;
+}
+
+size_t timing_wheel::advance(uint64_t now, std::vector<int>& expired) noexcept {
+	size_t count = expire(DUE_LIST, expired);
+	while (_size != 0) {
+		const uint64_t tick = next_event();
+		if (tick > now) break;
+		_now = tick;
+		// Top down, so a timer can fall through several levels on the same tick
+		if ((tick & ((1ULL << (LEVELS * SLOT_BITS)) - 1)) == 0) cascade(OVERFLOW_LIST);
+		for (int level = LEVELS - 1; level > 0; --level) {
+			if ((tick & ((1ULL << (level * SLOT_BITS)) - 1)) == 0) cascade(level * SLOTS + slot_at(tick, level));
+		}
+		count += expire(DUE_LIST, expired);
+		count += expire(slot_at(tick, 0), expired);
+	}
+	if (now > _now) _now = now;
+	return count;
+}
+
+void timing_wheel::clear() noexcept {
+	for (int list = 0; list < LIST_COUNT; ++list) {
+		for (int id = _heads[list]; id != -1; id = _timers[id].next) _timers[id].list = -1;
+		_heads[list] = -1;
+	}
+	memset(_occupied, 0, sizeof(_occupied));
+	_size = 0;
+}
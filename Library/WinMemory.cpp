@@ -4,7 +4,7 @@
 
 // WinMemory.cpp
 
-void* BaseAllocator::Allocate(int size) {
+void* BaseAllocator::Allocate(size_t size) {
 	return malloc(size);
 }
 
@@ -12,7 +12,7 @@ void BaseAllocator::Release(void* ptr) {
 	free(ptr);
 }
 
-void* StompAllocator::Allocate(int size) {
+void* StompAllocator::Allocate(size_t size) {
 	const uintptr_t pageCount = (size + PAGE_SIZE - 1) / PAGE_SIZE;
 	const uintptr_t dataOffset = pageCount * PAGE_SIZE - size;
 	void* basePtr = ::VirtualAlloc(NULL, pageCount * PAGE_SIZE, 
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <vector>
+#include <deque>
+#include <queue>
+#include <stack>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
 // WinMemory.h 
 
 class BaseAllocator {
 public:
-	static void* Allocate(int size);
+	static void* Allocate(size_t size);
 	static void  Release(void* ptr);
 };
 
@@ -12,26 +21,33 @@ class StompAllocator {
 private:
 	enum { PAGE_SIZE = 0x1000 };
 public:
-	static void* Allocate(int size);
+	static void* Allocate(size_t size);
 	static void  Release(void* ptr);
 };
 
 template<typename T> 
 class stl_allocator {
-	using value_type = T; 
 public:
+	using value_type = T; 
+
 	stl_allocator() {} 
 	template<typename U> 
 	stl_allocator(const stl_allocator<U>&) {} 
 
 	T* allocate(std::size_t count) {
-		const std::size_t size = count * sizeof(T);
-		return static_cast<T*>(BaseAllocator::Allocate(size));
+		if (count > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+		return static_cast<T*>(BaseAllocator::Allocate(count * sizeof(T)));
 	}
 
 	void deallocate(T* p, std::size_t count) noexcept {
 		BaseAllocator::Release(static_cast<void*>(p)); 
 	}
+
+	// Stateless: memory from any instance can be released through any other.
+	template<typename U>
+	bool operator==(const stl_allocator<U>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const stl_allocator<U>&) const noexcept { return false; }
 };  
 
 template<typename T>
@@ -6,8 +6,24 @@ int TestNewTracer();
 
 void test_cstr_hash_map();
 void test_cstr_hash_map_performance();
+void test_cstr_hash_map_incremental_rehash();
+void test_cstr_hash_map_node_allocator();
+void test_concurrent_cstr_hash_map();
+void test_static_cstr_map();
+void test_cstr_interner();
+void test_cstr_hash_map_string_view();
+void test_cstr_hash_map_emplace();
+void test_cstr_hash_map_snapshot();
+void test_dense_cstr_hash_map();
+void test_cstr_trie();
+void test_id_hash_map();
 
 void test_indexed_heap(); 
+void test_radix_heap();
+void test_timing_wheel();
+void test_multi_queue();
+void test_pathfinder();
+void test_malloc_vector();
 
 void test_guard_overflow() noexcept; 
 
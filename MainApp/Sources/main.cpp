@@ -16,7 +16,23 @@ int main() {
 
 	// test_cstr_hash_map();
 	// test_cstr_hash_map_performance();
+	// test_cstr_hash_map_incremental_rehash();
+	// test_cstr_hash_map_node_allocator();
+	// test_concurrent_cstr_hash_map();
+	// test_static_cstr_map();
+	// test_cstr_interner();
+	// test_cstr_hash_map_string_view();
+	// test_cstr_hash_map_emplace();
+	// test_cstr_hash_map_snapshot();
+	// test_dense_cstr_hash_map();
+	// test_cstr_trie();
+	// test_id_hash_map();
 	// test_indexed_heap(); 
+	// test_radix_heap();
+	// test_timing_wheel();
+	// test_multi_queue();
+	// test_pathfinder();
+	// test_malloc_vector();
 
 	// __debugbreak(); 
 
@@ -0,0 +1,192 @@
+#include "pch.h"
+#include "cstr_hash_map.h"
+#include "concurrent_cstr_hash_map.h"
+
+// Shared-mutex wrapped cstr_hash_map, the baseline the concurrent map replaces
+class locked_cstr_hash_map {
+private:
+    Win::SharedMutex _lock;
+    cstr_hash_map<int> _map;
+public:
+    explicit locked_cstr_hash_map(size_t capacity) : _lock(), _map(capacity) {}
+
+    bool find(const char* key, int& out) noexcept {
+        Win::SharedLockGuard guard(_lock);
+        auto it = _map.find(key);
+        if (it == _map.end()) return false;
+        out = it.value();
+        return true;
+    }
+    void insert(const char* key, int value) noexcept {
+        Win::ExclusiveLockGuard guard(_lock);
+        _map.insert(key, value);
+    }
+};
+
+static void test_concurrent_cstr_hash_map_correctness(const std::vector<std::string>& key_storage) {
+    printf("=== Concurrent Correctness ===\n");
+    const size_t N = key_storage.size();
+    const int THREADS = 8;
+    concurrent_cstr_hash_map<int> map(64);
+
+    // Each writer owns a disjoint key range, readers hammer every key meanwhile
+    std::atomic<bool> stop{ false };
+    std::atomic<size_t> bad_reads{ 0 };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < THREADS / 2; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t));
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t i = gen() % N;
+                int value = -1;
+                // A key is either absent or holds exactly i or -i
+                if (map.find(key_storage[i].c_str(), value)
+                    && value != static_cast<int>(i) && value != -static_cast<int>(i)) {
+                    bad_reads.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS / 2; ++t) {
+        writers.emplace_back([&, t]() {
+            for (size_t i = t; i < N; i += THREADS / 2) map.insert(key_storage[i].c_str(), static_cast<int>(i));
+            for (size_t i = t; i < N; i += THREADS) map.insert(key_storage[i].c_str(), -static_cast<int>(i));
+            for (size_t i = t; i < N; i += THREADS * 2) map.erase(key_storage[i].c_str());
+        });
+    }
+    for (auto& w : writers) w.join();
+    stop.store(true);
+    for (auto& r : readers) r.join();
+
+    size_t expected = 0;
+    for (size_t i = 0; i < N; ++i) {
+        size_t owner = i % (THREADS / 2);
+        bool erased = (i - owner) % (THREADS * 2) == 0 && owner < THREADS / 2;
+        int value = 0;
+        bool found = map.find(key_storage[i].c_str(), value);
+        assert(found != erased);
+        if (found) ++expected;
+    }
+    assert(bad_reads.load() == 0);
+    assert(map.size() == expected);
+    printf("PASSED\n\n");
+}
+
+// Writers keep reassigning a few hot keys on a small map, so every insert retires a node and reclaim
+// passes run constantly, while readers hold guards across many finds. A freed node would show up as a torn value.
+struct checked_value {
+    int value;
+    int check; // always ~value
+};
+
+static void test_concurrent_cstr_hash_map_reclamation(const std::vector<std::string>& key_storage) {
+    printf("=== Concurrent Reclamation Stress ===\n");
+    const size_t HOT_KEYS = 32;
+    const int THREADS = 8;
+    const int ROUNDS = 200000;
+    concurrent_cstr_hash_map<checked_value, 2> map(16);
+    for (size_t i = 0; i < HOT_KEYS; ++i) map.insert(key_storage[i].c_str(), checked_value{ 0, ~0 });
+
+    std::atomic<bool> stop{ false };
+    std::atomic<size_t> bad_reads{ 0 };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < THREADS / 2; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t));
+            while (!stop.load(std::memory_order_relaxed)) {
+                epoch_domain::guard g(epoch_domain::GetInstance()); // outer guard spans a whole batch
+                for (int i = 0; i < 64; ++i) {
+                    checked_value value{ 0, ~0 };
+                    if (!map.find(key_storage[gen() % HOT_KEYS].c_str(), value) || value.check != ~value.value) {
+                        bad_reads.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS / 2; ++t) {
+        writers.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t + 100));
+            for (int r = 1; r <= ROUNDS; ++r) map.insert(key_storage[gen() % HOT_KEYS].c_str(), checked_value{ r, ~r });
+        });
+    }
+    for (auto& w : writers) w.join();
+    stop.store(true);
+    for (auto& r : readers) r.join();
+    assert(bad_reads.load() == 0);
+    assert(map.size() == HOT_KEYS);
+    printf("PASSED\n\n");
+}
+
+template<typename Map>
+static long long bench_mixed_workload(Map& map, const std::vector<std::string>& key_storage,
+    int thread_count, int write_percent, size_t ops_per_thread) {
+    const size_t N = key_storage.size();
+    std::atomic<int> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t * 7919));
+            volatile long long sum = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t op = 0; op < ops_per_thread; ++op) {
+                size_t i = gen() % N;
+                if (static_cast<int>(gen() % 100) < write_percent) {
+                    map.insert(key_storage[i].c_str(), static_cast<int>(op));
+                }
+                else {
+                    int value = 0;
+                    if (map.find(key_storage[i].c_str(), value)) sum += value;
+                }
+            }
+        });
+    }
+    while (ready.load() != thread_count) {}
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static void test_concurrent_cstr_hash_map_performance(const std::vector<std::string>& key_storage) {
+    printf("=== Concurrent Read/Write Benchmark ===\n");
+    const size_t OPS_PER_THREAD = 1000000;
+    const int thread_counts[] = { 1, 2, 4, 8, 16 };
+    const int write_percents[] = { 1, 10, 50 };
+
+    for (int write_percent : write_percents) {
+        printf("-- %d%% writes --\n", write_percent);
+        for (int thread_count : thread_counts) {
+            concurrent_cstr_hash_map<int> sharded(key_storage.size());
+            locked_cstr_hash_map locked(key_storage.size());
+            for (size_t i = 0; i < key_storage.size(); ++i) {
+                sharded.insert(key_storage[i].c_str(), static_cast<int>(i));
+                locked.insert(key_storage[i].c_str(), static_cast<int>(i));
+            }
+
+            long long sharded_us = bench_mixed_workload(sharded, key_storage, thread_count, write_percent, OPS_PER_THREAD);
+            long long locked_us = bench_mixed_workload(locked, key_storage, thread_count, write_percent, OPS_PER_THREAD);
+            double total_ops = static_cast<double>(OPS_PER_THREAD) * thread_count;
+            printf("threads %2d | concurrent_cstr_hash_map: %8.2f Mops/s | SharedMutex + cstr_hash_map: %8.2f Mops/s\n",
+                thread_count, total_ops / static_cast<double>(sharded_us), total_ops / static_cast<double>(locked_us));
+        }
+    }
+    printf("\n");
+}
+
+void test_concurrent_cstr_hash_map() {
+    constexpr size_t N = 200000;
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) {
+        key_storage[i] = "key_" + std::to_string(i);
+    }
+
+    test_concurrent_cstr_hash_map_correctness(key_storage);
+    test_concurrent_cstr_hash_map_reclamation(key_storage);
+    test_concurrent_cstr_hash_map_performance(key_storage);
+}
@@ -1,5 +1,10 @@
 #include "pch.h"
 #include "cstr_hash_map.h"
+#include "static_cstr_map.h"
+#include "cstr_interner.h"
+#include "SerialBuffer.h"
+#include "cstr_hash_map_view.h"
+#include "dense_cstr_hash_map.h"
 #include <chrono>
 #include <iostream>
 #include <string>
@@ -28,6 +33,26 @@ void test_cstr_hash_map_performance() noexcept {
         << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
         << " us\n";
 
+    // 1-1) cstr_hash_map bulk load: default capacity, one sizing, parallel hashing
+    std::vector<std::pair<const char*, int>> entries(N);
+    for (size_t i = 0; i < N; ++i) entries[i] = { keys[i], static_cast<int>(i) };
+    cstr_hash_map<int> bulk_map;
+    start = std::chrono::high_resolution_clock::now();
+    bulk_map.build(entries.begin(), entries.end());
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map build: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+        << " us\n";
+    assert(bulk_map.size() == N && bulk_map.find(keys[N / 3]).value() == static_cast<int>(N / 3));
+    cstr_hash_map<int> threaded_map; // explicit thread count: chunk bounds are covered whatever the machine
+    threaded_map.build(entries.begin(), entries.begin() + 1000003, 4);
+    assert(threaded_map.size() == 1000003);
+    for (size_t i = 0; i < 1000003; i += 997) assert(threaded_map.find(keys[i]).value() == static_cast<int>(i));
+    const std::pair<const char*, int> duplicates[] = { { "a", 1 }, { "b", 2 }, { "a", 3 } };
+    cstr_hash_map<int> small_map;
+    small_map.build(std::begin(duplicates), std::end(duplicates));
+    assert(small_map.size() == 2 && small_map["a"] == 3 && small_map["b"] == 2);
+
     // 2) unordered_map<std::string, int> ׽Ʈ
     std::unordered_map<std::string, int> std_map;
     std_map.reserve(N);
@@ -127,3 +152,726 @@ void test_cstr_hash_map() noexcept {
 }
 
 
+
+void test_cstr_hash_map_incremental_rehash() noexcept {
+    constexpr size_t N = 4000000;
+
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) {
+        key_storage[i] = "key_" + std::to_string(i);
+    }
+
+    // Both maps stay alive until the end, so freed nodes of one run
+    // do not turn into allocator work inside the other run's timings
+    cstr_hash_map<int> full_map(64, false);
+    cstr_hash_map<int> incremental_map(64, true);
+    cstr_hash_map<int>* maps[2] = { &full_map, &incremental_map };
+
+    // Worst single insert latency, starting small so the table doubles many times
+    for (int mode = 0; mode < 2; ++mode) {
+        cstr_hash_map<int>& cstr_map = *maps[mode];
+        long long worst_ns = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < N; ++i) {
+            auto op_start = std::chrono::high_resolution_clock::now();
+            cstr_map.insert(key_storage[i].c_str(), static_cast<int>(i));
+            auto op_end = std::chrono::high_resolution_clock::now();
+            long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(op_end - op_start).count();
+            if (ns > worst_ns) worst_ns = ns;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << (cstr_map.is_incremental_rehash() ? "incremental" : "stop-the-world") << " rehash insert total: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+            << " us, worst op: " << worst_ns / 1000 << " us\n";
+    }
+
+    for (int mode = 0; mode < 2; ++mode) {
+        cstr_hash_map<int>& cstr_map = *maps[mode];
+
+        // Every key must stay reachable whether it sits in the old or the new table
+        size_t found = 0;
+        for (size_t i = 0; i < N; ++i) {
+            auto it = cstr_map.find(key_storage[i].c_str());
+            if (it != cstr_map.end() && it.value() == static_cast<int>(i)) ++found;
+        }
+        size_t iterated = 0;
+        for (auto it = cstr_map.begin(); it != cstr_map.end(); ++it) ++iterated;
+        assert(found == N);
+        assert(iterated == N);
+        assert(cstr_map.size() == N);
+
+        for (size_t i = 0; i < N; i += 2) {
+            cstr_map.erase(key_storage[i].c_str());
+        }
+        assert(cstr_map.size() == N / 2);
+        assert(!cstr_map.contains(key_storage[0].c_str()));
+        assert(cstr_map.contains(key_storage[1].c_str()));
+    }
+}
+
+template<template<typename> class NodeAllocator>
+static void bench_cstr_hash_map_node_allocator(const char* name, const std::vector<std::string>& key_storage) noexcept {
+    const size_t N = key_storage.size();
+    cstr_hash_map<int, NodeAllocator> cstr_map(N);
+
+    for (int round = 0; round < 2; ++round) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < N; ++i) {
+            cstr_map.insert(key_storage[i].c_str(), static_cast<int>(i));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        long long insert_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        volatile long long sum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (auto it = cstr_map.begin(); it != cstr_map.end(); ++it) sum += it.value();
+        end = std::chrono::high_resolution_clock::now();
+        long long iterate_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        cstr_map.clear();
+        end = std::chrono::high_resolution_clock::now();
+        long long clear_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        assert(cstr_map.empty());
+        std::cout << name << (round == 0 ? " (cold)" : " (refill)")
+            << " insert: " << insert_us << " us, iterate: " << iterate_us
+            << " us, clear: " << clear_us << " us\n";
+    }
+}
+
+void test_cstr_hash_map_node_allocator() noexcept {
+    constexpr size_t N = 4000000;
+
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) {
+        key_storage[i] = "key_" + std::to_string(i);
+    }
+
+    bench_cstr_hash_map_node_allocator<heap_node_allocator>("heap_node_allocator", key_storage);
+    bench_cstr_hash_map_node_allocator<slab_node_allocator>("slab_node_allocator", key_storage);
+}
+
+static constexpr auto opcode_table = make_static_cstr_map<int>({
+    { "nop", 0 }, { "add", 1 }, { "sub", 2 }, { "mul", 3 }, { "div", 4 }, { "mod", 5 },
+    { "and", 6 }, { "or", 7 }, { "xor", 8 }, { "not", 9 }, { "shl", 10 }, { "shr", 11 },
+    { "load", 12 }, { "store", 13 }, { "push", 14 }, { "pop", 15 }, { "call", 16 }, { "ret", 17 },
+    { "jmp", 18 }, { "jz", 19 }, { "jnz", 20 }, { "cmp", 21 }, { "inc", 22 }, { "dec", 23 },
+    { "Net::Send", 24 }, { "Net::Recv", 25 }, { "Net::Accept", 26 }, { "Net::Close", 27 },
+});
+
+// Resolved entirely by the compiler
+static_assert(*opcode_table.find("add") == 1, "static_cstr_map compile-time lookup");
+static_assert(*opcode_table.find("Net::Close") == 27, "static_cstr_map compile-time lookup");
+static_assert(opcode_table.find("missing") == nullptr, "static_cstr_map compile-time miss");
+static_assert(cstr_hash("add") == cstr_hash("add"), "cstr_hash is constexpr");
+
+void test_static_cstr_map() noexcept {
+    printf("=== static_cstr_map ===\n");
+    const char* names[] = {
+        "nop", "add", "sub", "mul", "div", "mod", "and", "or", "xor", "not", "shl", "shr",
+        "load", "store", "push", "pop", "call", "ret", "jmp", "jz", "jnz", "cmp", "inc", "dec",
+        "Net::Send", "Net::Recv", "Net::Accept", "Net::Close",
+    };
+    constexpr size_t COUNT = sizeof(names) / sizeof(names[0]);
+
+    // Runtime keys live in a different buffer than the literals in the table
+    std::vector<std::string> runtime_names(names, names + COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        const int* value = opcode_table.find(runtime_names[i].c_str());
+        assert(value && *value == static_cast<int>(i));
+    }
+    assert(!opcode_table.contains("ad"));
+    assert(!opcode_table.contains("addd"));
+    assert(opcode_table.get("Net::", -1) == -1);
+
+    cstr_hash_map<int> dynamic_map(64);
+    for (size_t i = 0; i < COUNT; ++i) dynamic_map.insert(names[i], static_cast<int>(i));
+
+    constexpr size_t LOOKUPS = 20000000;
+    volatile int sum = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        sum += *opcode_table.find(runtime_names[i % COUNT].c_str());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "static_cstr_map find: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        sum += dynamic_map.find(runtime_names[i % COUNT].c_str()).value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map find: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    // A hash folded at compile time must match the runtime one
+    constexpr size_t send_hash = cstr_hash("Net::Send");
+    assert(dynamic_map.find("Net::Send", send_hash).value() == 24 && send_hash == cstr_hash(runtime_names[24].c_str()));
+
+    // Same runtime keys with their hashes computed ahead of time. Only the hash rounds are saved:
+    // the key is still measured with strlen and memcmp'd against the chain node.
+    std::vector<size_t> runtime_hashes(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) runtime_hashes[i] = cstr_hash(runtime_names[i].c_str());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        sum += dynamic_map.find(runtime_names[i % COUNT].c_str(), runtime_hashes[i % COUNT]).value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map find (precomputed hash): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+    printf("PASSED\n\n");
+}
+
+void test_cstr_interner() noexcept {
+    printf("=== cstr_interner ===\n");
+    constexpr size_t N = 1000000;
+    constexpr size_t LOOKUPS = 10000000;
+    cstr_interner names;
+    cstr_hash_map<int> map(N);
+
+    // Keys are formatted into one reused buffer; the map only ever sees interned pointers
+    char buffer[64];
+    for (size_t i = 0; i < N; ++i) {
+        snprintf(buffer, sizeof(buffer), "key_%zu", i);
+        map.insert(names.intern(buffer), static_cast<int>(i));
+    }
+    assert(names.size() == N);
+
+    // Interning again returns the same pointer and copies nothing
+    size_t bytes = names.bytes();
+    snprintf(buffer, sizeof(buffer), "key_%zu", N / 2);
+    const char* first = names.find(buffer);
+    assert(first != nullptr && first != buffer);
+    assert(names.intern(std::string(buffer)) == first);
+    assert(names.bytes() == bytes && names.size() == N);
+    assert(map.find(buffer).value() == static_cast<int>(N / 2));
+    assert(names.find("missing") == nullptr);
+
+    // Strings larger than a chunk go to a chunk of their own
+    std::string big(200000, 'x');
+    const char* big_ptr = names.intern(big);
+    assert(big == big_ptr && names.intern(big.c_str()) == big_ptr);
+
+    std::vector<const char*> interned(N);
+    std::vector<std::string> copies(N);
+    for (size_t i = 0; i < N; ++i) {
+        snprintf(buffer, sizeof(buffer), "key_%zu", i);
+        interned[i] = names.find(buffer);
+        copies[i] = buffer;
+    }
+
+    volatile long long sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        sum += map.find(copies[(i * 7919) % N].c_str()).value();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "find (separate copy of key): "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        sum += map.find(interned[(i * 7919) % N]).value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "find (interned pointer, a == b fast path): "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    names.clear();
+    assert(names.size() == 0 && names.bytes() == 0 && names.find("key_0") == nullptr);
+    assert(names.intern("key_0") != nullptr && names.size() == 1);
+    printf("PASSED\n\n");
+}
+
+static size_t djb2_hash(const char* key) noexcept {
+    size_t hash = 5381;
+    while (*key) hash = ((hash << 5) + hash) + static_cast<unsigned char>(*key++);
+    return hash;
+}
+
+void test_cstr_hash_map_string_view() noexcept {
+    printf("=== cstr_hash_map string_view lookup ===\n");
+    constexpr size_t N = 100000;
+    constexpr int ROUNDS = 100;
+    std::vector<std::string> key_storage(N);
+    cstr_hash_map<int> map(N);
+    for (size_t i = 0; i < N; ++i) {
+        key_storage[i] = "Game::Player::Handler_" + std::to_string(i);
+        map.insert(key_storage[i].c_str(), static_cast<int>(i));
+    }
+
+    // Hash values agree across the constexpr, const char* and string_view paths
+    static_assert(cstr_hash("Net::Send") == cstr_hash("Net::Send!", 9), "length-bounded hash");
+    assert(cstr_hash(std::string_view("Net::Send")) == cstr_hash("Net::Send"));
+    for (size_t i = 0; i < N; i += 997) {
+        assert(cstr_hash(std::string_view(key_storage[i])) == cstr_hash(key_storage[i].c_str()));
+    }
+
+    // A view into a larger buffer is not NUL-terminated and still matches exactly
+    std::string line = key_storage[42] + "=value";
+    std::string_view name(line.data(), key_storage[42].size());
+    assert(map.find(name).value() == 42);
+    assert(map.find(std::string_view(line.data(), name.size() + 1)) == map.end());
+    assert(map.find(line.c_str()) == map.end());
+    assert(map.find(name).key_view() == name && map.find(name).key() == key_storage[42].c_str());
+
+    // Length-prefixed names packed into SerialBuffer packets, looked up in place
+    std::vector<SerialBuffer> packets((N + 63) / 64);
+    for (size_t i = 0; i < N; ++i) {
+        SerialBuffer& packet = packets[i / 64];
+        unsigned char length = static_cast<unsigned char>(key_storage[i].size());
+        packet << length;
+        for (char c : key_storage[i]) packet << c;
+    }
+
+    volatile long long sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (SerialBuffer& packet : packets) {
+            const char* base = packet.GetReadPtr();
+            const char* ptr = base;
+            const char* last = base + packet.GetUsedSize();
+            while (ptr < last) {
+                size_t length = static_cast<unsigned char>(*ptr++);
+                sum += map.find(std::string_view(ptr, length)).value();
+                ptr += length;
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "find(string_view) straight from SerialBuffer: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (SerialBuffer& packet : packets) {
+            const char* base = packet.GetReadPtr();
+            const char* ptr = base;
+            const char* last = base + packet.GetUsedSize();
+            while (ptr < last) {
+                size_t length = static_cast<unsigned char>(*ptr++);
+                std::string copy(ptr, length);
+                sum += map.find(copy.c_str()).value();
+                ptr += length;
+            }
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "copy to std::string + find(const char*): "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    // Raw hash throughput on the same keys: byte-at-a-time djb2 vs 8 byte words
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < N; ++i) sum += djb2_hash(key_storage[i].c_str()) & 1;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "djb2 hash: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < N; ++i) sum += cstr_hash(std::string_view(key_storage[i])) & 1;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash (8 byte words): "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    // Inserted keys are C strings; a view that is not NUL-terminated finds and erases them
+    const char* literal = "Net::Accept";
+    const std::string_view packet("Net::Accept;Net::Close", 22);
+    map[literal] = -1;
+    assert(map.find(packet.substr(0, 11)).key() == literal && !map.contains(packet.substr(0, 8)));
+    map.erase(packet.substr(0, 11));
+    assert(!map.contains(literal) && map.size() == N);
+    printf("PASSED\n\n");
+}
+
+struct copy_counted {
+    static int copies;
+    static int moves;
+    static int constructs;
+    std::vector<long long> samples;
+
+    copy_counted() noexcept { ++constructs; }
+    copy_counted(size_t count, long long value) : samples(count, value) { ++constructs; }
+    copy_counted(const copy_counted& other) : samples(other.samples) { ++copies; }
+    copy_counted(copy_counted&& other) noexcept : samples(std::move(other.samples)) { ++moves; }
+    copy_counted& operator=(const copy_counted& other) { samples = other.samples; ++copies; return *this; }
+    copy_counted& operator=(copy_counted&& other) noexcept { samples = std::move(other.samples); ++moves; return *this; }
+};
+int copy_counted::copies = 0;
+int copy_counted::moves = 0;
+int copy_counted::constructs = 0;
+
+static cstr_hash_map<std::vector<long long>> make_sample_map(const std::vector<std::string>& keys) {
+    cstr_hash_map<std::vector<long long>> map;
+    for (const std::string& key : keys) map.try_emplace(key.c_str(), 64, 1LL);
+    return map; // moved out, no value is copied
+}
+
+void test_cstr_hash_map_emplace() noexcept {
+    printf("=== cstr_hash_map emplace / move ===\n");
+    {
+        cstr_hash_map<copy_counted> map;
+        copy_counted::copies = copy_counted::moves = copy_counted::constructs = 0;
+
+        // try_emplace builds the value in the node
+        auto result = map.try_emplace("a", 16, 7LL);
+        assert(result.second && result.first.value().samples.size() == 16);
+        assert(copy_counted::constructs == 1 && copy_counted::copies == 0 && copy_counted::moves == 0);
+
+        // An existing key constructs nothing and leaves the arguments alone
+        copy_counted keep(4, 1);
+        result = map.try_emplace("a", std::move(keep));
+        assert(!result.second && keep.samples.size() == 4 && result.first.value().samples.size() == 16);
+        result = map.emplace("a", 32, 0LL);
+        assert(!result.second && copy_counted::constructs == 2);
+
+        // insert moves its argument in, and onto the existing value on assign
+        map.insert("b", copy_counted(8, 2));
+        map.insert("a", std::move(keep));
+        assert(copy_counted::copies == 0 && map.find("a").value().samples.size() == 4);
+
+        // operator[] value-initializes in place, no temporary to move
+        int moves = copy_counted::moves;
+        map["c"].samples.push_back(3);
+        assert(copy_counted::moves == moves && copy_counted::copies == 0);
+
+        // Move construction and assignment steal the nodes, the source stays usable
+        cstr_hash_map<copy_counted> moved(std::move(map));
+        assert(moved.size() == 3 && map.size() == 0 && map.find("a") == map.end());
+        map.insert("d", copy_counted(1, 4));
+        assert(map.size() == 1);
+        map = std::move(moved);
+        assert(map.size() == 3 && map.contains("b") && !map.contains("d") && moved.empty());
+        assert(copy_counted::copies == 0);
+    }
+    {
+        // Moving a map in the middle of an incremental rehash keeps both tables
+        cstr_hash_map<int> map(8, true);
+        std::vector<std::string> keys(1000);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i] = "key_" + std::to_string(i);
+            map.insert(keys[i].c_str(), static_cast<int>(i));
+        }
+        bool rehashing = map.is_rehashing();
+        cstr_hash_map<int> moved(std::move(map));
+        assert(moved.is_rehashing() == rehashing && !map.is_rehashing());
+        for (size_t i = 0; i < keys.size(); ++i) assert(moved.find(keys[i].c_str()).value() == static_cast<int>(i));
+    }
+
+    // Profiler-style values: vector payloads inserted by copy, by move and in place
+    constexpr size_t N = 200000;
+    constexpr size_t SAMPLES = 64;
+    std::vector<std::string> keys(N);
+    for (size_t i = 0; i < N; ++i) keys[i] = "Section_" + std::to_string(i);
+    const std::vector<long long> prototype(SAMPLES, 1);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        cstr_hash_map<std::vector<long long>> map(N);
+        for (size_t i = 0; i < N; ++i) {
+            std::vector<long long> samples(prototype);
+            map.insert(keys[i].c_str(), samples); // lvalue: one copy into the argument
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "insert (copy): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        cstr_hash_map<std::vector<long long>> map(N);
+        for (size_t i = 0; i < N; ++i) {
+            map.insert(keys[i].c_str(), std::vector<long long>(prototype));
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "insert (move): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        cstr_hash_map<std::vector<long long>> map(N);
+        for (size_t i = 0; i < N; ++i) {
+            map.try_emplace(keys[i].c_str(), SAMPLES, 1LL);
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "try_emplace: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    cstr_hash_map<std::vector<long long>> returned = make_sample_map(keys);
+    end = std::chrono::high_resolution_clock::now();
+    assert(returned.size() == N && returned.find(keys[N - 1].c_str()).value().size() == SAMPLES);
+    std::cout << "build + return by value: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+    printf("PASSED\n\n");
+}
+
+// Writes bytes to path, opens it with cstr_hash_map_view<int> and looks up keys[0, count), whose values are their indices.
+// Returns -1 if open() rejects the file, otherwise how many keys were found; null_keys counts entries key() refuses.
+static int snapshot_found(const char* path, const std::vector<char>& bytes,
+    const std::vector<std::string>& keys, size_t count, size_t* null_keys = nullptr) noexcept {
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "wb") != 0 || !file) return -1;
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+    cstr_hash_map_view<int> view;
+    if (!view.open(path)) return -1;
+    int found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int* value = view.find(keys[i].c_str());
+        if (!value) continue;
+        assert(*value == static_cast<int>(i));
+        ++found;
+    }
+    size_t refused = 0;
+    for (const cstr_snapshot_entry<int>& entry : view) {
+        const char* key = view.key(entry);
+        if (!key) ++refused;
+        else assert(strlen(key) == entry.length);
+    }
+    if (null_keys) *null_keys = refused;
+    return found;
+}
+
+void test_cstr_hash_map_snapshot() noexcept {
+    printf("=== cstr_hash_map snapshot ===\n");
+    constexpr size_t N = 2000000;
+    const char* path = "cstr_hash_map_snapshot.bin";
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) key_storage[i] = "Game::Item::Name_" + std::to_string(i);
+
+    // What every process start pays today: build the table from scratch
+    auto start = std::chrono::high_resolution_clock::now();
+    cstr_hash_map<int> map;
+    for (size_t i = 0; i < N; ++i) map.insert(key_storage[i].c_str(), static_cast<int>(i));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "build cstr_hash_map: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    bool saved = map.save(path);
+    end = std::chrono::high_resolution_clock::now();
+    assert(saved);
+    std::cout << "save: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        cstr_hash_map_view<int> view(path);
+        const int* first = view.find("Game::Item::Name_12345");
+        end = std::chrono::high_resolution_clock::now();
+        assert(view.is_open() && view.size() == N && first && *first == 12345);
+    }
+    std::cout << "open view + first find: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    cstr_hash_map_view<int> view(path);
+    for (size_t i = 0; i < N; i += 101) {
+        const int* value = view.find(key_storage[i].c_str());
+        assert(value && *value == static_cast<int>(i));
+    }
+    assert(view.find("Game::Item::Name_") == nullptr && !view.contains("missing"));
+    std::string line = key_storage[7] + ";";
+    assert(*view.find(std::string_view(line.data(), key_storage[7].size())) == 7);
+    size_t visited = 0;
+    for (const auto& entry : view) {
+        assert(strlen(view.key(entry)) == entry.length);
+        ++visited;
+    }
+    assert(visited == N);
+
+    volatile long long sum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; ++i) sum += map.find(key_storage[(i * 7919) % N].c_str()).value();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map find: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; ++i) sum += *view.find(key_storage[(i * 7919) % N].c_str());
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map_view find: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    // A file written for another value type is rejected
+    cstr_hash_map_view<long long> wrong_type;
+    assert(!wrong_type.open(path) && !wrong_type.is_open() && wrong_type.find("Game::Item::Name_1") == nullptr);
+    view.close();
+
+    // Truncated and corrupted files are never read out of bounds: a bad header or section is rejected by open(),
+    // a bad bucket run or key offset reads as a miss
+    {
+        cstr_hash_map<int> small;
+        for (size_t i = 0; i < 100; ++i) small.insert(key_storage[i].c_str(), static_cast<int>(i));
+        bool small_saved = small.save(path);
+        assert(small_saved);
+        FILE* file = nullptr;
+        bool opened = fopen_s(&file, path, "rb") == 0 && file;
+        assert(opened);
+        fseek(file, 0, SEEK_END);
+        std::vector<char> good(static_cast<size_t>(ftell(file)));
+        fseek(file, 0, SEEK_SET);
+        size_t read = fread(good.data(), 1, good.size(), file);
+        fclose(file);
+        size_t null_keys = 0;
+        assert(read == good.size() && snapshot_found(path, good, key_storage, 100, &null_keys) == 100 && null_keys == 0);
+
+        typedef cstr_snapshot_entry<int> Entry;
+        const cstr_snapshot_header header = *reinterpret_cast<const cstr_snapshot_header*>(good.data());
+        auto start_at = [&](std::vector<char>& bytes, uint64_t b) {
+            return reinterpret_cast<uint64_t*>(bytes.data() + header.buckets + sizeof(uint64_t) * b);
+        };
+        auto entry_at = [&](std::vector<char>& bytes, uint64_t i) {
+            return reinterpret_cast<Entry*>(bytes.data() + header.entries + sizeof(Entry) * i);
+        };
+        auto found_after = [&](auto edit) {
+            std::vector<char> bytes = good;
+            edit(bytes, reinterpret_cast<cstr_snapshot_header*>(bytes.data()));
+            return snapshot_found(path, bytes, key_storage, 100, &null_keys);
+        };
+        auto opens_after = [&](auto edit) { return found_after(edit) >= 0; };
+
+        // Cut anywhere, with file_size patched to match: rejected before the string pool, keys past the cut missed inside it
+        for (size_t cut = 0; cut < good.size(); cut += 7) {
+            const int found = found_after([&](std::vector<char>& bytes, cstr_snapshot_header* h) {
+                if (cut >= sizeof(cstr_snapshot_header)) h->file_size = cut;
+                bytes.resize(cut);
+            });
+            assert(found < 100 && (cut >= header.strings || found == -1));
+        }
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->file_size += 1; }));
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->bucket_count = uint64_t(1) << 62; }));
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->size = UINT64_MAX / sizeof(Entry) + 2; }));
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->buckets = UINT64_MAX - 8; }));
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->buckets += 4; })); // misaligned
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->entries = h->buckets; }));
+        assert(!opens_after([](std::vector<char>&, cstr_snapshot_header* h) { h->strings = h->file_size + 64; }));
+        assert(!opens_after([&](std::vector<char>& bytes, cstr_snapshot_header*) { *start_at(bytes, 0) = 1; }));
+        assert(!opens_after([&](std::vector<char>& bytes, cstr_snapshot_header* h) { *start_at(bytes, h->bucket_count) = h->size - 1; }));
+        // Bucket runs and key offsets are checked per lookup: the damaged ones miss, the rest still work
+        for (uint64_t b = 1; b < header.bucket_count; ++b) {
+            if (*start_at(good, b) == *start_at(good, b + 1)) continue;
+            assert(found_after([&](std::vector<char>& bytes, cstr_snapshot_header*) { *start_at(bytes, b) = *start_at(bytes, b + 1) + 1; }) < 100);
+            assert(found_after([&](std::vector<char>& bytes, cstr_snapshot_header* h) { *start_at(bytes, b) = h->size + 1; }) < 100);
+            break;
+        }
+        assert(found_after([&](std::vector<char>& bytes, cstr_snapshot_header*) { entry_at(bytes, 3)->key = UINT32_MAX; }) == 99 && null_keys == 1);
+        assert(found_after([&](std::vector<char>& bytes, cstr_snapshot_header*) { entry_at(bytes, 3)->length = UINT32_MAX; }) == 99 && null_keys == 1);
+        assert(found_after([&](std::vector<char>& bytes, cstr_snapshot_header* h) {
+            Entry* last = entry_at(bytes, h->size - 1);
+            last->key = static_cast<uint32_t>(h->file_size - h->strings - last->length); // ends on the last byte, no room for its NUL
+        }) == 99 && null_keys == 1);
+        assert(found_after([](std::vector<char>& bytes, cstr_snapshot_header*) { bytes.back() = 'x'; }) == 100 && null_keys == 1); // last key loses its NUL
+    }
+    remove(path);
+    printf("PASSED\n\n");
+}
+
+void test_dense_cstr_hash_map() noexcept {
+    printf("=== dense_cstr_hash_map ===\n");
+    constexpr size_t N = 1000000;
+    constexpr size_t KEEP = 1000;
+    constexpr int ITERATIONS = 1000;
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) key_storage[i] = "Section_" + std::to_string(i);
+
+    // Random insert / erase / find against std::unordered_map
+    {
+        dense_cstr_hash_map<int> map;
+        std::unordered_map<std::string, int> reference;
+        std::mt19937 gen(7);
+        for (int op = 0; op < 2000000; ++op) {
+            const std::string& key = key_storage[gen() % 50000];
+            int value = static_cast<int>(gen());
+            switch (gen() % 3) {
+            case 0: map.insert(key.c_str(), value); reference[key] = value; break;
+            case 1: map.erase(key.c_str()); reference.erase(key); break;
+            default: {
+                auto it = map.find(key.c_str());
+                auto ref = reference.find(key);
+                assert((it == map.end()) == (ref == reference.end()));
+                assert(it == map.end() || it.value() == ref->second);
+            }
+            }
+        }
+        assert(map.size() == reference.size());
+        size_t visited = 0;
+        for (auto it = map.begin(); it != map.end(); ++it, ++visited) {
+            assert(reference.at(it.key()) == it.value());
+        }
+        assert(visited == reference.size());
+    }
+
+    // A map that once held N keys and now holds KEEP: report-style full iteration
+    cstr_hash_map<long long> chained(64);
+    dense_cstr_hash_map<long long> dense(64);
+    for (size_t i = 0; i < N; ++i) {
+        chained.insert(key_storage[i].c_str(), static_cast<long long>(i));
+        dense.insert(key_storage[i].c_str(), static_cast<long long>(i));
+    }
+    for (size_t i = KEEP; i < N; ++i) {
+        chained.erase(key_storage[i].c_str());
+        dense.erase(key_storage[i].c_str());
+    }
+    assert(chained.size() == KEEP && dense.size() == KEEP);
+    for (size_t i = 0; i < KEEP; ++i) assert(dense.find(key_storage[i].c_str()).value() == static_cast<long long>(i));
+
+    volatile long long sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ITERATIONS; ++round) {
+        for (auto it = chained.begin(); it != chained.end(); ++it) sum += it.value();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map iterate " << KEEP << " keys (grown to " << N << "): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < ITERATIONS; ++round) {
+        for (auto it = dense.begin(); it != dense.end(); ++it) sum += it.value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "dense_cstr_hash_map iterate " << KEEP << " keys (grown to " << N << "): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    // Full tables
+    for (size_t i = KEEP; i < N; ++i) {
+        chained.insert(key_storage[i].c_str(), static_cast<long long>(i));
+        dense.insert(key_storage[i].c_str(), static_cast<long long>(i));
+    }
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (auto it = chained.begin(); it != chained.end(); ++it) sum += it.value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map iterate " << N << " keys x10: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (auto it = dense.begin(); it != dense.end(); ++it) sum += it.value();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "dense_cstr_hash_map iterate " << N << " keys x10: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; ++i) sum += chained.find(key_storage[(i * 7919) % N].c_str()).value();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map find: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; ++i) sum += dense.find(key_storage[(i * 7919) % N].c_str()).value();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "dense_cstr_hash_map find: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+    printf("PASSED\n\n");
+}
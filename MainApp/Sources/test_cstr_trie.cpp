@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "cstr_hash_map.h"
+#include "cstr_trie.h"
+#include <map>
+
+static void test_cstr_trie_correctness() {
+    printf("=== cstr_trie correctness ===\n");
+    // Short keys over a small alphabet: many shared prefixes, keys that are prefixes of others,
+    // and every node size growing and shrinking
+    std::mt19937 gen(11);
+    std::vector<std::string> key_storage(60000);
+    for (std::string& key : key_storage) {
+        size_t length = 1 + gen() % 24;
+        for (size_t i = 0; i < length; ++i) {
+            key.push_back(gen() % 4 == 0 ? static_cast<char>(1 + gen() % 255) : static_cast<char>('a' + gen() % 3));
+        }
+    }
+    std::sort(key_storage.begin(), key_storage.end());
+    key_storage.erase(std::unique(key_storage.begin(), key_storage.end()), key_storage.end());
+
+    cstr_trie<int> trie;
+    std::map<std::string, int> reference;
+    for (int op = 0; op < 1000000; ++op) {
+        const std::string& key = key_storage[gen() % key_storage.size()];
+        int value = static_cast<int>(gen());
+        switch (gen() % 4) {
+        case 0:
+        case 1:
+            trie.insert(key.c_str(), value);
+            reference[key] = value;
+            break;
+        case 2:
+            assert(trie.erase(key.c_str()) == (reference.erase(key) == 1));
+            break;
+        default: {
+            const int* found = trie.find(key.c_str());
+            auto ref = reference.find(key);
+            assert((found == nullptr) == (ref == reference.end()));
+            assert(!found || *found == ref->second);
+        }
+        }
+    }
+    assert(trie.size() == reference.size());
+
+    // Full iteration follows strcmp order
+    auto ref_it = reference.begin();
+    trie.for_each([&](const char* key, int& value) {
+        assert(ref_it != reference.end() && ref_it->first == key && ref_it->second == value);
+        ++ref_it;
+    });
+    assert(ref_it == reference.end());
+
+    // Prefix iteration matches a lower_bound range scan
+    for (int query = 0; query < 2000; ++query) {
+        const std::string& source = key_storage[gen() % key_storage.size()];
+        std::string prefix = source.substr(0, gen() % (source.size() + 1));
+        auto it = reference.lower_bound(prefix);
+        trie.for_each_prefix(prefix, [&](const char* key, int&) {
+            assert(it != reference.end() && it->first == key);
+            ++it;
+        });
+        assert(it == reference.end() || it->first.compare(0, prefix.size(), prefix) != 0);
+    }
+
+    // Longest prefix against brute force
+    for (int query = 0; query < 2000; ++query) {
+        std::string text = key_storage[gen() % key_storage.size()] + static_cast<char>('a' + gen() % 3);
+        size_t expected = 0;
+        const int* expected_value = nullptr;
+        for (size_t length = 1; length <= text.size(); ++length) {
+            auto ref = reference.find(text.substr(0, length));
+            if (ref != reference.end()) {
+                expected = length;
+                expected_value = &ref->second;
+            }
+        }
+        size_t matched = 0;
+        const int* value = trie.longest_prefix(text, &matched);
+        assert((value == nullptr) == (expected_value == nullptr));
+        assert(!value || (matched == expected && *value == *expected_value));
+    }
+
+    for (const std::string& key : key_storage) trie.erase(key.c_str());
+    assert(trie.empty());
+
+    // Command routing
+    cstr_trie<int> routes;
+    routes.insert("move", 1);
+    routes.insert("move north", 2);
+    routes.insert("say", 3);
+    size_t matched = 0;
+    assert(*routes.longest_prefix("move north now", &matched) == 2 && matched == 10);
+    assert(*routes.longest_prefix("move east", &matched) == 1 && matched == 4);
+    assert(routes.longest_prefix("mov") == nullptr && routes.longest_prefix("") == nullptr);
+    printf("PASSED\n\n");
+}
+
+static void test_cstr_trie_performance() {
+    printf("=== cstr_trie vs cstr_hash_map ===\n");
+    constexpr size_t N = 1000000;
+    const char* modules[] = { "Net::", "Game::", "Db::", "Render::", "Audio::", "Script::", "Ui::", "Physics::" };
+    std::vector<std::string> key_storage(N);
+    for (size_t i = 0; i < N; ++i) {
+        key_storage[i] = std::string(modules[i % 8]) + "Handler_" + std::to_string(i);
+    }
+    std::vector<size_t> order(N);
+    for (size_t i = 0; i < N; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+
+    cstr_trie<int> trie;
+    cstr_hash_map<int> map;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i : order) trie.insert(key_storage[i].c_str(), static_cast<int>(i));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_trie insert: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i : order) map.insert(key_storage[i].c_str(), static_cast<int>(i));
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map insert: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    // Lookups through separate copies, so neither side gets a pointer-equality shortcut
+    std::vector<std::string> queries(key_storage);
+    std::shuffle(order.begin(), order.end(), std::mt19937(4));
+    volatile long long sum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i : order) sum += *trie.find(queries[i].c_str());
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_trie find: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i : order) sum += map.find(queries[i].c_str()).value();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map find: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    // "All sections starting with Net::"
+    size_t trie_count = 0;
+    start = std::chrono::high_resolution_clock::now();
+    trie.for_each_prefix("Net::", [&](const char*, int&) { ++trie_count; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_trie for_each_prefix(\"Net::\"): "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    size_t map_count = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        if (strncmp(it.key(), "Net::", 5) == 0) ++map_count;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "cstr_hash_map full scan + strncmp: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+    assert(trie_count == N / 8 && map_count == N / 8);
+    printf("PASSED\n\n");
+}
+
+void test_cstr_trie() {
+    test_cstr_trie_correctness();
+    test_cstr_trie_performance();
+}
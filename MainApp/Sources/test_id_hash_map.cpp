@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "id_hash_map.h"
+#include "../../Library/WinMemory.h"
+
+struct Session {
+    uint64_t id;
+    std::string name;
+    Session(uint64_t i, std::string n) : id(i), name(std::move(n)) {}
+};
+
+static void test_id_hash_map_correctness() {
+    printf("=== id_hash_map correctness ===\n");
+    std::mt19937_64 gen(5);
+    id_hash_map<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+
+    // Small key range so runs wrap, collide and get shifted back constantly; key 0 included.
+    // Every multiple of 4096 is also fed in, which piles up on the same home slots without the mixer.
+    for (int op = 0; op < 2000000; ++op) {
+        uint64_t key = (op & 1) ? gen() % 5000 : (gen() % 64) * 4096;
+        switch (gen() % 5) {
+        case 0:
+        case 1:
+            map.insert(key, op);
+            reference[key] = op;
+            break;
+        case 2:
+            map.erase(key);
+            reference.erase(key);
+            break;
+        case 3:
+            map[key] += 1;
+            reference[key] += 1;
+            break;
+        default: {
+            auto it = map.find(key);
+            auto ref = reference.find(key);
+            assert((it == map.end()) == (ref == reference.end()));
+            assert(it == map.end() || (it.key() == key && it.value() == ref->second));
+        }
+        }
+        assert(map.size() == reference.size());
+    }
+
+    size_t visited = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        assert(reference.at(it.key()) == it.value());
+        ++visited;
+    }
+    assert(visited == reference.size());
+
+    for (auto& entry : reference) map.erase(entry.first);
+    assert(map.empty() && map.begin() == map.end());
+
+    // Non-trivial values, try_emplace and move
+    id_hash_map<uint64_t, Session> sessions;
+    for (uint64_t id = 0; id < 1000; ++id) {
+        assert(sessions.try_emplace(id, id, "player_" + std::to_string(id)).second);
+    }
+    assert(!sessions.try_emplace(7, 7, "duplicate").second);
+    assert(sessions.find(7)->name == "player_7");
+    for (uint64_t id = 0; id < 1000; id += 2) sessions.erase(id);
+
+    id_hash_map<uint64_t, Session> moved(std::move(sessions));
+    assert(sessions.empty() && moved.size() == 500);
+    assert(!moved.contains(0) && moved.find(999)->name == "player_999");
+    moved.clear();
+    assert(moved.empty() && !moved.contains(999));
+
+    // Signed keys: -1 and 0 are ordinary ids
+    id_hash_map<int, int> signed_map;
+    signed_map[-1] = 1;
+    signed_map[0] = 2;
+    assert(signed_map[-1] == 1 && signed_map[0] == 2 && signed_map.size() == 2);
+    printf("PASSED\n\n");
+}
+
+static void test_id_hash_map_performance() {
+    printf("=== id_hash_map vs HashMap ===\n");
+    constexpr size_t N = 1000000;
+    std::mt19937_64 gen(9);
+    std::vector<uint64_t> ids(N);
+    for (size_t i = 0; i < N; ++i) ids[i] = (static_cast<uint64_t>(i) << 20) | (gen() & 0xFFFFF); // unique 64 bit session ids
+    std::vector<uint64_t> lookups(ids);
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(1));
+    std::vector<uint64_t> misses(N);
+    for (size_t i = 0; i < N; ++i) misses[i] = ids[i] + (static_cast<uint64_t>(N) << 20);
+
+    auto report = [](const char* label, std::chrono::high_resolution_clock::time_point start) {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << label << ": "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+    };
+    volatile uint64_t sum = 0;
+    size_t found = 0;
+
+    {
+        id_hash_map<uint64_t, uint64_t> map;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < N; ++i) map[ids[i]] = i;
+        report("id_hash_map insert", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int round = 0; round < 4; ++round) {
+            for (uint64_t id : lookups) sum += map.find(id).value();
+        }
+        report("id_hash_map find hit x4", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint64_t id : misses) found += map.contains(id);
+        report("id_hash_map find miss", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint64_t id : lookups) map.erase(id);
+        report("id_hash_map erase", start);
+        assert(map.empty());
+    }
+
+    {
+        HashMap<uint64_t, uint64_t> map;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < N; ++i) map[ids[i]] = i;
+        report("HashMap insert", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int round = 0; round < 4; ++round) {
+            for (uint64_t id : lookups) sum += map.find(id)->second;
+        }
+        report("HashMap find hit x4", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint64_t id : misses) found += map.count(id);
+        report("HashMap find miss", start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint64_t id : lookups) map.erase(id);
+        report("HashMap erase", start);
+        assert(map.empty());
+    }
+    assert(found == 0);
+    printf("PASSED\n\n");
+}
+
+void test_id_hash_map() {
+    test_id_hash_map_correctness();
+    test_id_hash_map_performance();
+}
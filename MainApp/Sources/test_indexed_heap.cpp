@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "indexed_heap.h"
+#include <set>
+#include <climits>
 
 // 1. ⺻  ׽Ʈ
 void test_basic() {
@@ -44,6 +46,10 @@ void test_decrease_key() {
     pq.decrease_key(3, 100.0f);
     assert(pq.get_priority(3) == 20.0f);
 
+    //   id T() ش
+    assert(pq.get_priority(0) == 0.0f && pq.get_priority(99) == 0.0f);
+    assert(pq.get_priority(-1) == 0.0f && pq.get_priority(1000) == 0.0f);
+
     printf("PASSED\n\n");
 }
 
@@ -286,6 +292,331 @@ void test_dijkstra_simulation() {
 }
 
 
+// 7. (Arity) Ȯ / 1M ó 
+template<int Arity>
+static void check_arity_order() {
+    const int N = 20000;
+    std::mt19937 gen(Arity);
+    indexed_heap<int, Arity> pq(N);
+    std::vector<int> priority(N);
+    for (int id = 0; id < N; id++) {
+        priority[id] = gen() % 100000;
+        pq.push(id, priority[id]);
+    }
+    for (int i = 0; i < N / 4; i++) {
+        int id = gen() % N;
+        priority[id] = priority[id] / 2;
+        pq.decrease_key(id, priority[id]);
+    }
+    int last = -1;
+    while (!pq.empty()) {
+        int id = pq.pop();
+        assert(priority[id] >= last);
+        last = priority[id];
+    }
+}
+
+template<int Arity>
+static void run_arity_throughput(const char* name, const std::vector<std::pair<int, float>>& operations) {
+    const int N = static_cast<int>(operations.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        indexed_heap<float, Arity> pq(N);
+        for (int i = 0; i < N; i++) pq.push(i, operations[i].second);
+        while (!pq.empty()) pq.pop();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    long long push_pop_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    // ٷ :    pop  , decrease_key  
+    start = std::chrono::high_resolution_clock::now();
+    {
+        indexed_heap<float, Arity> pq(N);
+        for (int i = 0; i < N; i++) pq.push(i, operations[i].second + 10000.0f);
+        for (int i = 0; i < N / 5; i++) {
+            for (int k = 0; k < 4; k++) {
+                int id = operations[(i * 4 + k) % N].first;
+                if (pq.contains(id)) pq.decrease_key(id, pq.get_priority(id) * 0.5f);
+            }
+            pq.pop();
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    long long mixed_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    printf("%s: push+pop %lld us, pop+decrease_key %lld us\n", name, push_pop_time, mixed_time);
+}
+
+void test_arity_throughput() {
+    printf("=== Arity Layout Test (1M) ===\n");
+    check_arity_order<2>();
+    check_arity_order<3>();
+    check_arity_order<4>();
+    check_arity_order<8>();
+
+    const int N = 1000000;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> id_dist(0, N - 1);
+    std::uniform_real_distribution<float> priority_dist(0.0f, 10000.0f);
+    std::vector<std::pair<int, float>> operations(N);
+    for (int i = 0; i < N; i++) {
+        operations[i].first = id_dist(gen);
+        operations[i].second = priority_dist(gen);
+    }
+
+    run_arity_throughput<2>("indexed_heap<float, 2>", operations);
+    run_arity_throughput<4>("indexed_heap<float, 4>", operations);
+    run_arity_throughput<8>("indexed_heap<float, 8>", operations);
+    printf("PASSED\n\n");
+}
+
+
+// 8. increase_key / update / erase / top ׽Ʈ
+void test_mutable_priority() {
+    printf("=== Mutable Priority Test ===\n");
+    const int N = 2000;
+    std::mt19937 gen(13);
+    indexed_heap<int> pq(N);
+    std::set<std::pair<int, int>> reference; // (priority, id)
+    std::vector<int> priority(N, -1);
+
+    for (int op = 0; op < 200000; op++) {
+        int id = gen() % N;
+        int value = gen() % 10000;
+        switch (gen() % 6) {
+        case 0:
+            pq.update(id, value);
+            if (priority[id] != -1) reference.erase(std::make_pair(priority[id], id));
+            priority[id] = value;
+            reference.insert(std::make_pair(value, id));
+            break;
+        case 1:
+            pq.increase_key(id, value);
+            if (priority[id] != -1 && value > priority[id]) {
+                reference.erase(std::make_pair(priority[id], id));
+                priority[id] = value;
+                reference.insert(std::make_pair(value, id));
+            }
+            break;
+        case 2:
+            assert(pq.erase(id) == (priority[id] != -1));
+            if (priority[id] != -1) reference.erase(std::make_pair(priority[id], id));
+            priority[id] = -1;
+            break;
+        case 3: {
+            int top_id, top_priority;
+            if (pq.pop(top_id, top_priority)) {
+                assert(top_priority == reference.begin()->first && priority[top_id] == top_priority);
+                reference.erase(reference.begin());
+                priority[top_id] = -1;
+            }
+            else {
+                assert(reference.empty());
+            }
+            break;
+        }
+        default:
+            pq.push(id, value);
+            if (priority[id] == -1 || value < priority[id]) {
+                if (priority[id] != -1) reference.erase(std::make_pair(priority[id], id));
+                priority[id] = value;
+                reference.insert(std::make_pair(value, id));
+            }
+            break;
+        }
+        assert(pq.size() == reference.size());
+        assert(pq.empty() ? pq.top() == -1 : pq.top_priority() == reference.begin()->first);
+    }
+
+    // Ÿ̸  / 翹
+    indexed_heap<long long> timers(16);
+    timers.push(1, 100);
+    timers.push(2, 200);
+    timers.push(3, 300);
+    assert(timers.erase(1) && !timers.erase(1));
+    timers.update(3, 50);
+    timers.update(2, 400);
+    assert(timers.top() == 3 && timers.top_priority() == 50);
+    int id;
+    long long when;
+    assert(timers.pop(id, when) && id == 3 && when == 50);
+    assert(timers.pop(id, when) && id == 2 && when == 400);
+    assert(!timers.pop(id, when));
+
+    printf("PASSED\n\n");
+}
+
+// 9. id  Ȯ / assign(O(n)) ׽Ʈ
+void test_growth_and_assign() {
+    printf("=== Growable Ids / Bulk Assign Test ===\n");
+    indexed_heap<int> grow(4);
+    grow.push(1000, 5);
+    grow.update(70000, 1);
+    grow.push(3, 9);
+    assert(grow.size() == 3 && grow.contains(70000) && !grow.contains(69999));
+    assert(grow.pop() == 70000 && grow.pop() == 1000 && grow.pop() == 3);
+    grow.decrease_key(1 << 20, 0); //   id 
+    assert(grow.empty());
+
+    const int N = 1000000;
+    std::mt19937 gen(21);
+    std::vector<int> ids(N);
+    std::vector<float> priorities(N);
+    for (int i = 0; i < N; i++) {
+        ids[i] = i;
+        priorities[i] = static_cast<float>(gen() % 1000000);
+    }
+    std::shuffle(ids.begin(), ids.end(), gen);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    indexed_heap<float> pushed;
+    for (int i = 0; i < N; i++) pushed.push(ids[i], priorities[i]);
+    auto end = std::chrono::high_resolution_clock::now();
+    long long push_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    indexed_heap<float> assigned;
+    assigned.assign(ids, priorities);
+    end = std::chrono::high_resolution_clock::now();
+    long long assign_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    printf("%d push: %lld us, assign: %lld us\n", N, push_time, assign_time);
+
+    assert(assigned.size() == static_cast<size_t>(N));
+    float last = -1.0f;
+    int id;
+    float priority;
+    while (assigned.pop(id, priority)) {
+        assert(priority >= last && pushed.get_priority(id) == priority);
+        last = priority;
+    }
+
+    // ߺ id   priority , assign   ü
+    assigned.push(5, 1.0f);
+    assigned.assign({ 7, 8, 7 }, { 30.0f, 20.0f, 10.0f });
+    assert(assigned.size() == 2 && !assigned.contains(5));
+    assert(assigned.pop() == 7 && assigned.pop() == 8);
+
+    printf("PASSED\n\n");
+}
+
+// 10. (Compare) ø  / max-heap ׽Ʈ
+struct FloatOrder { // Backups/PQHeap   
+    virtual ~FloatOrder() {}
+    virtual bool before(float a, float b) const = 0;
+};
+struct FloatLessOrder : FloatOrder {
+    bool before(float a, float b) const override { return a < b; }
+};
+struct FloatGreaterOrder : FloatOrder {
+    bool before(float a, float b) const override { return a > b; }
+};
+struct VirtualCompare {
+    const FloatOrder* order;
+    VirtualCompare(const FloatOrder* o = nullptr) : order(o) {}
+    bool operator()(float a, float b) const { return order->before(a, b); }
+};
+
+//       ִ 
+struct CloserTo {
+    int target;
+    CloserTo(int t = 0) : target(t) {}
+    bool operator()(int a, int b) const {
+        int da = std::abs(a - target), db = std::abs(b - target);
+        return da < db || (da == db && a < b);
+    }
+};
+
+// push / pop / decrease_key ȥ ۾; sign max-heap   ȣ    
+template<typename Heap>
+static long long run_comparator_throughput(Heap& pq, const std::vector<std::pair<int, float>>& operations, float sign, double& checksum) {
+    const int N = static_cast<int>(operations.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; i++) pq.push(i, sign * operations[i].second);
+    for (int i = 0; i < N; i++) {
+        if (i % 2 == 0) {
+            int id;
+            float priority;
+            if (pq.pop(id, priority)) checksum += sign * priority;
+        }
+        else {
+            const int id = operations[i].first;
+            if (pq.contains(id)) pq.decrease_key(id, sign * (pq.get_priority(id) * sign - 1.0f));
+        }
+    }
+    int id;
+    float priority;
+    while (pq.pop(id, priority)) checksum += sign * priority;
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+void test_comparator_policy() {
+    printf("=== Compare Policy Test ===\n");
+    // max_indexed_heap ȣ  min-heap   ؾ Ѵ
+    const int M = 2000;
+    std::mt19937 gen(31);
+    max_indexed_heap<int> max_pq(M);
+    min_indexed_heap<int> negated(M);
+    for (int op = 0; op < 200000; op++) {
+        int id = gen() % M;
+        int value = gen() % 10000;
+        switch (gen() % 6) {
+        case 0: max_pq.update(id, value); negated.update(id, -value); break;
+        case 1: max_pq.increase_key(id, value); negated.increase_key(id, -value); break;
+        case 2: assert(max_pq.erase(id) == negated.erase(id)); break;
+        case 3: max_pq.decrease_key(id, value); negated.decrease_key(id, -value); break;
+        case 4: {
+            int a_id = -1, b_id = -1, a = 0, b = 0;
+            bool popped = max_pq.pop(a_id, a);
+            assert(popped == negated.pop(b_id, b));
+            assert(!popped || a == -b);
+            break;
+        }
+        default: max_pq.push(id, value); negated.push(id, -value); break;
+        }
+        assert(max_pq.size() == negated.size());
+        assert(max_pq.empty() || max_pq.top_priority() == -negated.top_priority());
+    }
+    max_indexed_heap<int> bulk;
+    bulk.assign({ 1, 2, 3, 2 }, { 10, 30, 20, 5 }); // ߺ id   ռ (30) 
+    assert(bulk.get_priority(2) == 30 && bulk.pop() == 2 && bulk.pop() == 3 && bulk.pop() == 1);
+
+    indexed_heap<int, 4, CloserTo> nearest(16, CloserTo(50));
+    nearest.push(0, 10);
+    nearest.push(1, 45);
+    nearest.push(2, 90);
+    nearest.push(3, 53);
+    assert(nearest.pop() == 3 && nearest.pop() == 1 && nearest.pop() == 0 && nearest.pop() == 2);
+
+    // : ⺻ std::less / std::greater /   (1M)
+    const int N = 1000000;
+    std::vector<std::pair<int, float>> operations(N);
+    for (int i = 0; i < N; i++) {
+        operations[i].first = gen() % N;
+        operations[i].second = static_cast<float>(gen() % 10000000);
+    }
+    FloatLessOrder less_order;
+    FloatGreaterOrder greater_order;
+    const FloatOrder* order = operations[0].first >= 0 ? static_cast<const FloatOrder*>(&less_order) : &greater_order;
+
+    indexed_heap<float> min_pq(N);
+    max_indexed_heap<float> max_float(N);
+    indexed_heap<float, 4, VirtualCompare> virtual_pq(N, VirtualCompare(order));
+    long long less_time = LLONG_MAX, max_time = LLONG_MAX, virtual_time = LLONG_MAX;
+    for (int round = 0; round < 3; round++) { //  3ȸ, ּڰ
+        double checksum_less = 0.0, checksum_max = 0.0, checksum_virtual = 0.0;
+        less_time = std::min(less_time, run_comparator_throughput(min_pq, operations, 1.0f, checksum_less));
+        max_time = std::min(max_time, run_comparator_throughput(max_float, operations, -1.0f, checksum_max));
+        virtual_time = std::min(virtual_time, run_comparator_throughput(virtual_pq, operations, 1.0f, checksum_virtual));
+        assert(checksum_less == checksum_max && checksum_less == checksum_virtual);
+    }
+    printf("indexed_heap<float> (std::less): %lld us\n", less_time);
+    printf("max_indexed_heap<float> (std::greater): %lld us\n", max_time);
+    printf("virtual compare (PQHeap style): %lld us\n", virtual_time);
+
+    printf("PASSED\n\n");
+}
+
 void test_indexed_heap() {
     test_basic();
     test_decrease_key();
@@ -294,5 +625,9 @@ void test_indexed_heap() {
     test_performance();
     test_stress();
 	test_dijkstra_simulation(); 
+    test_arity_throughput();
+    test_mutable_priority();
+    test_growth_and_assign();
+    test_comparator_policy();
     printf("=== All Tests Passed ===\n");
 }
\ No newline at end of file
@@ -0,0 +1,445 @@
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include "malloc_vector.h"
+#include "NewTracer.h"
+
+// Not trivially copyable: counts the assignments malloc_vector makes
+struct Counted {
+    static int assignments;
+    int value;
+    Counted(int v = 0) : value(v) {}
+    Counted(const Counted& other) : value(other.value) {}
+    Counted& operator=(const Counted& other) { value = other.value; ++assignments; return *this; }
+    bool operator==(const Counted& other) const { return value == other.value; }
+};
+int Counted::assignments = 0;
+
+static void test_malloc_vector_basic() {
+    printf("=== malloc_vector basic ===\n");
+    malloc_vector<uint64_t> numbers;
+    for (uint64_t i = 0; i < 100000; i++) numbers.push_back(i * 3);
+    assert(numbers.size() == 100000 && numbers.capacity() >= 100000);
+    for (size_t i = 0; i < numbers.size(); i++) assert(numbers[i] == i * 3);
+    assert(*numbers.find(300) == 300 && numbers.find(301) == numbers.end());
+    numbers.erase(numbers.find(0));
+    numbers.insert(numbers.begin(), 7);
+    assert(numbers.front() == 7 && numbers[1] == 3 && numbers.back() == 99999 * 3);
+    numbers.resize(10);
+    numbers.reserve(1 << 20);
+    assert(numbers.size() == 10 && numbers[9] == 27);
+
+    // Grows through assignment, not memcpy / realloc
+    malloc_vector<Counted> counted(1);
+    for (int i = 0; i < 100; i++) counted.push_back(Counted(i));
+    for (int i = 0; i < 100; i++) assert(counted[i].value == i);
+    assert(Counted::assignments > 100); // 100 stores + the copies made while growing
+
+    // push_back of the vector's own element, through every growth of the block it lives in
+    malloc_vector<Counted> self(1);
+    self.push_back(Counted(5));
+    for (int i = 0; i < 200; i++) self.push_back(self[self.size() / 2]);
+    for (size_t i = 0; i < self.size(); i++) assert(self[i].value == 5);
+
+    static_assert(std::is_trivially_copyable<NewTracer::Info>::value, "NewTracer records should grow with realloc");
+    malloc_vector<NewTracer::Info> records;
+    for (int i = 0; i < 1000; i++) records.push_back(NewTracer::Info(&records, i, __FILE__, i));
+    assert(records.size() == 1000 && records[999].size == 999 && records[999].line == 999);
+    printf("PASSED\n\n");
+}
+
+static void test_malloc_vector_reserved() {
+    printf("=== malloc_vector reserved mode ===\n");
+    const size_t N = 10000000;
+    malloc_vector<uint64_t> values(reserve_virtual, N);
+    assert(values.reserved_capacity() == N && values.capacity() == 0);
+    const uint64_t* base = values.data();
+    for (uint64_t i = 0; i < N; i++) {
+        values.push_back(i);
+        assert(values.data() == base);
+    }
+    assert(values.size() == N && values.capacity() == N);
+    values.push_back(N); // past the reservation: refused like a failed malloc
+    assert(values.size() == N && values.back() == N - 1);
+    values.erase(values.find(0));
+    values.insert(values.begin(), 42);
+    assert(values.front() == 42 && values[1] == 1 && values.data() == base);
+
+    malloc_vector<NewTracer::Info> records(reserve_virtual, 1000);
+    records.resize(1000);
+    records[999] = NewTracer::Info(nullptr, 999, __FILE__, __LINE__);
+    assert(records.capacity() == 1000 && records[999].size == 999);
+
+    // One writer, one reader without a lock: elements never move, only the published size is shared
+    malloc_vector<uint64_t> shared(reserve_virtual, N);
+    std::atomic<size_t> published{ 0 };
+    const uint64_t* shared_data = shared.data();
+    std::thread reader([&]() {
+        size_t seen = 0;
+        while (seen < N / 10) {
+            size_t size = published.load(std::memory_order_acquire);
+            for (; seen < size; seen++) assert(shared_data[seen] == seen * 7);
+        }
+    });
+    for (uint64_t i = 0; i < N / 10; i++) {
+        shared.push_back(i * 7);
+        published.store(shared.size(), std::memory_order_release);
+    }
+    reader.join();
+    printf("PASSED\n\n");
+}
+
+static void test_small_malloc_vector() {
+    printf("=== small_malloc_vector ===\n");
+    small_malloc_vector<uint64_t, 8> small;
+    assert(small.capacity() == 8 && small.is_inline());
+    for (uint64_t i = 0; i < 8; i++) small.push_back(i * 5);
+    assert(small.is_inline() && small.size() == 8);
+    const uint64_t* inline_data = small.data();
+    assert(reinterpret_cast<const char*>(inline_data) >= reinterpret_cast<const char*>(&small)
+        && reinterpret_cast<const char*>(inline_data) < reinterpret_cast<const char*>(&small) + sizeof(small));
+    small.insert(small.begin(), 99); // ninth element spills to malloc
+    assert(!small.is_inline() && small.size() == 9 && small.front() == 99);
+    for (uint64_t i = 0; i < 8; i++) assert(small[i + 1] == i * 5);
+    for (uint64_t i = 0; i < 1000; i++) small.push_back(i);
+    assert(small.size() == 1009 && small.back() == 999);
+
+    // Usable wherever a malloc_vector<T>& is expected
+    malloc_vector<uint64_t>& base = small;
+    base.erase(base.find(99));
+    assert(small.size() == 1008 && small.front() == 0);
+
+    small_malloc_vector<Counted, 4> counted;
+    for (int i = 0; i < 20; i++) counted.push_back(Counted(i));
+    for (int i = 0; i < 20; i++) assert(counted[i].value == i);
+    assert(!counted.is_inline());
+
+    small_malloc_vector<NewTracer::Info, 2> records;
+    records.push_back(NewTracer::Info(&records, 1, __FILE__, __LINE__));
+    records.push_back(NewTracer::Info(&records, 2, __FILE__, __LINE__));
+    records.push_back(NewTracer::Info(&records, 3, __FILE__, __LINE__));
+    assert(records.size() == 3 && records[2].size == 3 && !records.is_inline());
+
+    // Many short lived vectors of 0..8 elements
+    const int ROUNDS = 2000000;
+    uint64_t checksum_small = 0, checksum_malloc = 0, checksum_std = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        small_malloc_vector<uint64_t, 8> v;
+        for (int i = 0; i < (r & 7) + 1; i++) v.push_back(static_cast<uint64_t>(r + i));
+        checksum_small += v.back();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double small_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        malloc_vector<uint64_t> v;
+        for (int i = 0; i < (r & 7) + 1; i++) v.push_back(static_cast<uint64_t>(r + i));
+        checksum_malloc += v.back();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double malloc_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        std::vector<uint64_t> v;
+        for (int i = 0; i < (r & 7) + 1; i++) v.push_back(static_cast<uint64_t>(r + i));
+        checksum_std += v.back();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double std_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    assert(checksum_small == checksum_malloc && checksum_small == checksum_std);
+    printf("%d vectors of 1..8 uint64_t | small_malloc_vector<8>: %.1f ms | malloc_vector: %.1f ms | std::vector: %.1f ms\n",
+        ROUNDS, small_ms, malloc_ms, std_ms);
+    printf("PASSED\n\n");
+}
+
+template<typename T>
+static void check_same(const malloc_vector<T>& vector, const std::vector<T>& reference) {
+    assert(vector.size() == reference.size());
+    for (size_t i = 0; i < reference.size(); i++) assert(vector[i] == reference[i]);
+}
+
+// Random range operations against std::vector, including ranges taken from the vector itself
+template<typename T, typename MakeValue>
+static void check_range_operations(malloc_vector<T>& vector, MakeValue make_value, unsigned int seed) {
+    typedef typename malloc_vector<T>::iterator Iterator;
+    std::mt19937 gen(seed);
+    std::vector<T> reference;
+    std::vector<T> source;
+    for (int op = 0; op < 3000; op++) {
+        source.clear();
+        size_t count = gen() % 40;
+        for (size_t i = 0; i < count; i++) source.push_back(make_value(gen()));
+        const T* first = source.data();
+        const T* last = source.data() + source.size();
+        size_t size = reference.size();
+        switch (gen() % 8) {
+        case 0:
+            vector.append(first, last);
+            reference.insert(reference.end(), source.begin(), source.end());
+            break;
+        case 1:
+            if (size > 0) { // from itself
+                size_t from = gen() % size, to = from + gen() % (size - from + 1);
+                vector.append(vector.data() + from, vector.data() + to);
+                std::vector<T> part(reference.begin() + from, reference.begin() + to);
+                reference.insert(reference.end(), part.begin(), part.end());
+            }
+            break;
+        case 2: {
+            size_t at = gen() % (size + 1);
+            vector.insert(Iterator(vector.data() + at), first, last);
+            reference.insert(reference.begin() + at, source.begin(), source.end());
+            break;
+        }
+        case 3:
+            if (size > 0) { // from itself, overlapping the insert point
+                size_t at = gen() % (size + 1), from = gen() % size, to = from + gen() % (size - from + 1);
+                std::vector<T> part(reference.begin() + from, reference.begin() + to);
+                vector.insert(Iterator(vector.data() + at), vector.data() + from, vector.data() + to);
+                reference.insert(reference.begin() + at, part.begin(), part.end());
+            }
+            break;
+        case 4: {
+            size_t from = gen() % (size + 1), to = from + gen() % (size - from + 1);
+            vector.erase(Iterator(vector.data() + from), Iterator(vector.data() + to));
+            reference.erase(reference.begin() + from, reference.begin() + to);
+            break;
+        }
+        case 5: {
+            size_t new_size = gen() % 300;
+            T value = make_value(gen());
+            vector.resize(new_size, value);
+            reference.resize(new_size, value);
+            break;
+        }
+        case 6:
+            if (size > 0) { // push_back of an element of itself, often right at a growth
+                size_t from = gen() % size;
+                T value = reference[from];
+                vector.push_back(vector[from]);
+                reference.push_back(value);
+            }
+            break;
+        default:
+            if (size > 0) { // a single element of itself
+                size_t from = gen() % size, at = gen() % (size + 1);
+                T value = reference[from];
+                vector.insert(Iterator(vector.data() + at), vector[from]);
+                reference.insert(reference.begin() + at, value);
+            }
+            break;
+        }
+        check_same(vector, reference);
+    }
+}
+
+template<typename T>
+static void check_find(const std::vector<T>& values, const T& needle) {
+    malloc_vector<T> vector;
+    vector.append(values.data(), values.data() + values.size());
+    size_t expected = std::find(values.begin(), values.end(), needle) - values.begin();
+    size_t found = vector.find(needle).operator->() - vector.data();
+    assert(found == expected);
+}
+
+template<typename T>
+static void check_find_type(unsigned int seed) {
+    std::mt19937_64 gen(seed);
+    for (int round = 0; round < 300; round++) {
+        std::vector<T> values(gen() % 200);
+        for (auto& v : values) v = static_cast<T>(gen() % 16);
+        check_find(values, static_cast<T>(gen() % 20));
+        if (!values.empty()) check_find(values, values[gen() % values.size()]);
+    }
+}
+
+template<typename T>
+static size_t scalar_find(const T* data, size_t count, T value) {
+    for (size_t i = 0; i < count; i++) {
+        if (data[i] == value) return i;
+    }
+    return count;
+}
+
+static void test_malloc_vector_ranges() {
+    printf("=== malloc_vector range operations / find ===\n");
+    malloc_vector<uint32_t> numbers;
+    check_range_operations(numbers, [](uint64_t r) { return static_cast<uint32_t>(r % 1000); }, 1);
+    small_malloc_vector<uint32_t, 16> small;
+    check_range_operations(small, [](uint64_t r) { return static_cast<uint32_t>(r == 7 ? 0 : r); }, 2);
+    malloc_vector<uint64_t> reserved(reserve_virtual, 1 << 20);
+    check_range_operations(reserved, [](uint64_t r) { return r % 3 == 0 ? ~0ULL : r; }, 3);
+    malloc_vector<Counted> counted;
+    check_range_operations(counted, [](uint64_t r) { return Counted(static_cast<int>(r % 100)); }, 4);
+
+    check_find_type<uint8_t>(5);
+    check_find_type<int16_t>(6);
+    check_find_type<uint32_t>(7);
+    check_find_type<int64_t>(8);
+    check_find_type<float>(9);
+    check_find_type<double>(10);
+    check_find(std::vector<double>{ 1.0, -0.0, NAN }, 0.0);  // == semantics: -0.0 == 0.0
+    check_find(std::vector<float>{ NAN, 1.0f }, NAN);         // NaN never matches
+    int slots[64];
+    std::vector<int*> pointers;
+    for (int i = 0; i < 64; i++) pointers.push_back(&slots[(i * 37) % 64]);
+    for (int i = 0; i < 64; i++) check_find(pointers, &slots[i]);
+    check_find(pointers, static_cast<int*>(nullptr));
+
+    // Benchmarks
+    const size_t N = 1000000;
+    malloc_vector<uint64_t> big;
+    std::vector<uint64_t> input(N);
+    for (size_t i = 0; i < N; i++) input[i] = i * 2;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 20; r++) {
+        big.clear();
+        for (size_t i = 0; i < N; i++) big.push_back(input[i]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double push_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 20; r++) {
+        big.clear();
+        big.append(input.data(), input.data() + N);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double append_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    printf("20 x 1M uint64_t | push_back loop: %.1f ms | append: %.1f ms\n", push_ms, append_ms);
+
+    // Missing values in 100k elements (fits in L2): the whole vector is scanned every time
+    const size_t M = 100000;
+    const int FINDS = 2000;
+    size_t sink = 0;
+    double scalar_ms[3], simd_ms[3];
+    {
+        malloc_vector<uint32_t> u32;
+        malloc_vector<uint64_t> u64;
+        malloc_vector<const void*> addresses;
+        for (size_t i = 0; i < M; i++) {
+            u32.push_back(static_cast<uint32_t>(i * 2));
+            u64.push_back(i * 2);
+            addresses.push_back(&input[i]);
+        }
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += scalar_find<uint32_t>(u32.data(), M, 1 + r * 2);
+        end = std::chrono::high_resolution_clock::now();
+        scalar_ms[0] = std::chrono::duration<double, std::milli>(end - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += u32.find(1 + r * 2).operator->() - u32.data();
+        end = std::chrono::high_resolution_clock::now();
+        simd_ms[0] = std::chrono::duration<double, std::milli>(end - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += scalar_find<uint64_t>(u64.data(), M, 1 + r * 2);
+        end = std::chrono::high_resolution_clock::now();
+        scalar_ms[1] = std::chrono::duration<double, std::milli>(end - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += u64.find(1 + r * 2).operator->() - u64.data();
+        end = std::chrono::high_resolution_clock::now();
+        simd_ms[1] = std::chrono::duration<double, std::milli>(end - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += scalar_find<const void*>(addresses.data(), M, &input[M + r]);
+        end = std::chrono::high_resolution_clock::now();
+        scalar_ms[2] = std::chrono::duration<double, std::milli>(end - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < FINDS; r++) sink += addresses.find(&input[M + r]).operator->() - addresses.data();
+        end = std::chrono::high_resolution_clock::now();
+        simd_ms[2] = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+    assert(sink == 6 * FINDS * M);
+    printf("%d missing finds in 100k | uint32_t scalar %.1f / find %.1f ms | uint64_t scalar %.1f / find %.1f ms"
+        " | pointer scalar %.1f / find %.1f ms\n",
+        FINDS, scalar_ms[0], simd_ms[0], scalar_ms[1], simd_ms[1], scalar_ms[2], simd_ms[2]);
+
+    malloc_vector<uint64_t> front;
+    front.append(input.data(), input.data() + 10000);
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 100; r++) {
+        for (int i = 0; i < 100; i++) front.insert(front.begin(), input[i]);
+        for (int i = 0; i < 100; i++) front.erase(front.begin());
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double single_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 100; r++) {
+        front.insert(front.begin(), input.data(), input.data() + 100);
+        front.erase(front.begin(), malloc_vector<uint64_t>::iterator(front.data() + 100));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double range_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    assert(front.size() == 10000 && front[9999] == input[9999]);
+    printf("100 x 100 elements at the front of 10k | single insert / erase: %.1f ms | range insert / erase: %.1f ms\n",
+        single_ms, range_ms);
+    printf("PASSED\n\n");
+}
+
+// Address space for the largest benchmark size is reserved up front; pages are committed as it grows
+struct ReservedGrowth : malloc_vector<uint64_t> {
+    ReservedGrowth() : malloc_vector<uint64_t>(reserve_virtual, 100000000) {}
+};
+
+// The growth malloc_vector used before: malloc a block twice the size, memcpy, free
+struct CopyGrowth {
+    uint64_t* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+    ~CopyGrowth() { free(data); }
+    void push_back(uint64_t value) {
+        if (size == capacity) {
+            size_t new_capacity = capacity > 0 ? capacity * 2 : 4;
+            uint64_t* new_data = static_cast<uint64_t*>(malloc(sizeof(uint64_t) * new_capacity));
+            if (data) {
+                memcpy(new_data, data, sizeof(uint64_t) * size);
+                free(data);
+            }
+            data = new_data;
+            capacity = new_capacity;
+        }
+        data[size++] = value;
+    }
+    uint64_t& operator[](size_t i) { return data[i]; }
+};
+
+template<typename Vector>
+static double time_growth(size_t count, int& moves) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Vector vector;
+    moves = 0;
+    const void* last = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        vector.push_back(i);
+        const void* data = &vector[0];
+        if (data != last) {
+            if (last != nullptr) moves++;
+            last = data;
+        }
+    }
+    assert(vector[count - 1] == count - 1);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void test_malloc_vector_growth() {
+    printf("=== malloc_vector growth: push_back into an empty vector ===\n");
+    const size_t counts[] = { 1000000, 100000000 };
+    for (size_t count : counts) {
+        int copy_moves, realloc_moves, reserved_moves, std_moves;
+        double copy_ms = time_growth<CopyGrowth>(count, copy_moves);
+        double realloc_ms = time_growth<malloc_vector<uint64_t>>(count, realloc_moves);
+        double reserved_ms = time_growth<ReservedGrowth>(count, reserved_moves);
+        double std_ms = time_growth<std::vector<uint64_t>>(count, std_moves);
+        printf("%9zu x uint64_t | malloc + memcpy: %7.1f ms (%2d moves) | realloc: %7.1f ms (%2d moves)"
+            " | reserved: %7.1f ms (%d moves) | std::vector: %7.1f ms (%2d moves)\n",
+            count, copy_ms, copy_moves, realloc_ms, realloc_moves, reserved_ms, reserved_moves, std_ms, std_moves);
+    }
+    printf("\n");
+}
+
+void test_malloc_vector() {
+    test_malloc_vector_basic();
+    test_malloc_vector_reserved();
+    test_small_malloc_vector();
+    test_malloc_vector_ranges();
+    test_malloc_vector_growth();
+}
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "indexed_heap.h"
+#include "multi_queue.h"
+#include "WinMutex.h"
+
+static void test_multi_queue_correctness() {
+    printf("=== multi_queue correctness ===\n");
+    // Concurrent producers and consumers: every pushed value comes out exactly once
+    const int THREADS = 4;
+    const int PER_THREAD = 50000;
+    multi_queue<int> queue(THREADS);
+    std::vector<std::atomic<int>> seen(THREADS * PER_THREAD);
+    for (auto& s : seen) s.store(0);
+    std::atomic<int> popped{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t));
+            for (int i = 0; i < PER_THREAD; i++) {
+                queue.push(t * PER_THREAD + i, gen() % 100000);
+                int value;
+                uint64_t priority;
+                if (gen() % 2 && queue.try_pop(value, priority)) {
+                    seen[value].fetch_add(1);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    int value;
+    uint64_t priority;
+    while (queue.try_pop(value, priority)) {
+        seen[value].fetch_add(1);
+        popped.fetch_add(1);
+    }
+    assert(popped.load() == THREADS * PER_THREAD && queue.empty());
+    for (auto& s : seen) assert(s.load() == 1);
+
+    // Order quality on one thread: mean distance between pop position and true rank
+    const int N = 100000;
+    std::mt19937 gen(3);
+    std::vector<uint64_t> priorities(N);
+    for (int i = 0; i < N; i++) priorities[i] = (static_cast<uint64_t>(gen()) << 20) | static_cast<uint64_t>(i); // distinct
+    std::vector<uint64_t> sorted(priorities);
+    std::sort(sorted.begin(), sorted.end());
+    const unsigned int relaxations[] = { 1, 2, 4 };
+    for (unsigned int relaxation : relaxations) {
+        multi_queue<int> relaxed(8, relaxation);
+        for (int i = 0; i < N; i++) relaxed.push(i, priorities[i]);
+        double rank_error = 0.0;
+        for (int k = 0; k < N; k++) {
+            relaxed.try_pop(value, priority);
+            size_t rank = std::lower_bound(sorted.begin(), sorted.end(), priority) - sorted.begin();
+            rank_error += std::abs(static_cast<double>(rank) - k);
+        }
+        printf("8 threads x relaxation %u (%zu heaps): mean rank error %.1f\n",
+            relaxation, relaxed.queue_count(), rank_error / N);
+    }
+    printf("PASSED\n\n");
+}
+
+// Each thread alternates push and pop on a prefilled queue
+template<typename PushPop>
+static long long bench_threads(int thread_count, int ops_per_thread, PushPop push_pop) {
+    std::atomic<int> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(static_cast<unsigned int>(t * 7919 + 1));
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            for (int i = 0; i < ops_per_thread; i++) push_pop(t, i, gen);
+        });
+    }
+    while (ready.load() != thread_count) {}
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static void test_multi_queue_performance() {
+    printf("=== multi_queue vs Win::Mutex + indexed_heap ===\n");
+    const int PREFILL = 1000000;
+    const int OPS_PER_THREAD = 500000;
+    const int thread_counts[] = { 1, 2, 4, 8, 16 };
+    for (int thread_count : thread_counts) {
+        long long relaxed_us;
+        {
+            multi_queue<int> queue(thread_count);
+            for (int i = 0; i < PREFILL; i++) queue.push(i, static_cast<uint64_t>(i) * 2654435761u % PREFILL);
+            relaxed_us = bench_threads(thread_count, OPS_PER_THREAD, [&](int, int i, std::mt19937& gen) {
+                int value;
+                uint64_t priority;
+                if (queue.try_pop(value, priority)) queue.push(value, priority + gen() % 1000 + static_cast<uint64_t>(i & 1));
+            });
+        }
+
+        long long locked_us;
+        {
+            Win::Mutex lock;
+            indexed_heap<uint64_t> heap(PREFILL);
+            for (int i = 0; i < PREFILL; i++) heap.push(i, static_cast<uint64_t>(i) * 2654435761u % PREFILL);
+            locked_us = bench_threads(thread_count, OPS_PER_THREAD, [&](int, int i, std::mt19937& gen) {
+                Win::LockGuard guard(lock);
+                int id;
+                uint64_t priority;
+                if (heap.pop(id, priority)) heap.push(id, priority + gen() % 1000 + static_cast<uint64_t>(i & 1));
+            });
+        }
+
+        double total_ops = static_cast<double>(OPS_PER_THREAD) * thread_count * 2;
+        printf("threads %2d | multi_queue: %7.2f Mops/s | Win::Mutex + indexed_heap: %7.2f Mops/s\n",
+            thread_count, total_ops / relaxed_us, total_ops / locked_us);
+    }
+    printf("\n");
+}
+
+void test_multi_queue() {
+    test_multi_queue_correctness();
+    test_multi_queue_performance();
+}
@@ -0,0 +1,307 @@
+#include "pch.h"
+#include <cfloat>
+#include "pathfinder.h"
+
+// Perfect maze by randomized depth first carving on odd coordinates, then a few walls knocked out
+// so there is more than one route between most cells
+static grid_map make_maze(int cells_x, int cells_y, int extra_openings, unsigned int seed) {
+    grid_map map(cells_x * 2 + 1, cells_y * 2 + 1, false);
+    std::mt19937 gen(seed);
+    std::vector<uint8_t> visited(cells_x * cells_y, 0);
+    std::vector<int> stack;
+    stack.push_back(0);
+    visited[0] = 1;
+    map.set_walkable(1, 1, true);
+    const int dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    while (!stack.empty()) {
+        int cell = stack.back();
+        int cx = cell % cells_x, cy = cell / cells_x;
+        int options[4], count = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + dirs[d][0], ny = cy + dirs[d][1];
+            if (nx >= 0 && nx < cells_x && ny >= 0 && ny < cells_y && !visited[ny * cells_x + nx]) options[count++] = d;
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int d = options[gen() % count];
+        int nx = cx + dirs[d][0], ny = cy + dirs[d][1];
+        map.set_walkable(cx * 2 + 1 + dirs[d][0], cy * 2 + 1 + dirs[d][1], true);
+        map.set_walkable(nx * 2 + 1, ny * 2 + 1, true);
+        visited[ny * cells_x + nx] = 1;
+        stack.push_back(ny * cells_x + nx);
+    }
+    for (int i = 0; i < extra_openings; i++) {
+        int x = 1 + gen() % (map.width() - 2), y = 1 + gen() % (map.height() - 2);
+        map.set_walkable(x, y, true);
+    }
+    return map;
+}
+
+// Open field with scattered blocked cells and rectangular buildings
+static grid_map make_field(int width, int height, int block_percent, int buildings, unsigned int seed) {
+    grid_map map(width, height);
+    std::mt19937 gen(seed);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (static_cast<int>(gen() % 100) < block_percent) map.set_walkable(x, y, false);
+    for (int b = 0; b < buildings; b++) {
+        int w = 2 + gen() % (width / 8), h = 2 + gen() % (height / 8);
+        int x0 = gen() % (width - w), y0 = gen() % (height - h);
+        for (int y = y0; y < y0 + h; y++)
+            for (int x = x0; x < x0 + w; x++) map.set_walkable(x, y, false);
+    }
+    return map;
+}
+
+static int random_open_node(const grid_map& map, std::mt19937& gen) {
+    for (;;) {
+        int node = gen() % map.node_count();
+        if (map.walkable(map.x_of(node), map.y_of(node))) return node;
+    }
+}
+
+// Independent reference: lazy deletion Dijkstra over std::priority_queue
+static float reference_cost(const grid_map& map, int start, int goal) {
+    std::vector<double> dist(map.node_count(), 1e30);
+    typedef std::pair<double, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    dist[start] = 0.0;
+    open.push(Item(0.0, start));
+    while (!open.empty()) {
+        Item item = open.top();
+        open.pop();
+        if (item.first > dist[item.second]) continue;
+        if (item.second == goal) return static_cast<float>(item.first);
+        int x = map.x_of(item.second), y = map.y_of(item.second);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if ((dx == 0 && dy == 0) || !map.walkable(x + dx, y + dy)) continue;
+                if (dx != 0 && dy != 0 && (!map.walkable(x + dx, y) || !map.walkable(x, y + dy))) continue;
+                double next = item.first + (dx != 0 && dy != 0 ? 1.4142135623730951 : 1.0);
+                int node = map.node(x + dx, y + dy);
+                if (next < dist[node]) {
+                    dist[node] = next;
+                    open.push(Item(next, node));
+                }
+            }
+        }
+    }
+    return pathfinder::NO_PATH;
+}
+
+// Path must run start -> goal through open cells, one legal step at a time; returns its length
+static float check_path(const grid_map& map, const std::vector<int>& path, int start, int goal) {
+    assert(!path.empty() && path.front() == start && path.back() == goal);
+    float cost = 0.0f;
+    for (size_t i = 1; i < path.size(); i++) {
+        int x0 = map.x_of(path[i - 1]), y0 = map.y_of(path[i - 1]);
+        int x1 = map.x_of(path[i]), y1 = map.y_of(path[i]);
+        int dx = x1 - x0, dy = y1 - y0;
+        assert(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx != 0 || dy != 0));
+        assert(map.walkable(x1, y1));
+        if (dx != 0 && dy != 0) {
+            assert(map.walkable(x0 + dx, y0) && map.walkable(x0, y0 + dy));
+            cost += grid_map::SQRT2;
+        }
+        else {
+            cost += 1.0f;
+        }
+    }
+    return cost;
+}
+
+static bool same_cost(float a, float b) {
+    return std::abs(a - b) <= 1e-3f * (1.0f + std::abs(b));
+}
+
+static void test_pathfinder_correctness() {
+    printf("=== pathfinder correctness ===\n");
+    pathfinder finder;
+    std::vector<int> path;
+
+    // Hand checked: a wall with one gap
+    {
+        grid_map map(7, 5);
+        for (int y = 0; y < 5; y++) map.set_walkable(3, y, y == 4);
+        int start = map.node(0, 0), goal = map.node(6, 0);
+        // The gap (3,4) can only be entered and left straight (the wall end blocks the diagonals):
+        // (0,0) -> (2,4) is 2 diagonal + 2 straight steps, through the gap 2 more, and (4,4) -> (6,0) mirrors the first leg
+        float expected = 4 * grid_map::SQRT2 + 6;
+        assert(same_cost(finder.dijkstra(map, start, goal, &path), expected));
+        assert(same_cost(check_path(map, path, start, goal), expected));
+        assert(same_cost(finder.astar(map, start, goal, octile_heuristic(map), &path), expected));
+        assert(same_cost(finder.jps(map, start, goal, &path), expected));
+        assert(same_cost(check_path(map, path, start, goal), expected));
+        assert(finder.dijkstra(map, start, start, &path) == 0.0f && path.size() == 1);
+        assert(finder.jps(map, start, start, &path) == 0.0f && path.size() == 1);
+
+        map.set_walkable(3, 4, false); // sealed
+        assert(finder.dijkstra(map, start, goal, &path) == pathfinder::NO_PATH);
+        assert(finder.astar(map, start, goal, octile_heuristic(map)) == pathfinder::NO_PATH);
+        assert(finder.jps(map, start, goal) == pathfinder::NO_PATH);
+        assert(finder.jps(map, start, map.node(3, 2)) == pathfinder::NO_PATH); // blocked goal
+    }
+
+    // Random fields and mazes of mixed sizes through one pathfinder: every method agrees with the reference
+    std::mt19937 gen(5);
+    int queries = 0, unreachable = 0;
+    for (int round = 0; round < 60; round++) {
+        grid_map map = round % 2
+            ? make_maze(5 + gen() % 30, 5 + gen() % 30, gen() % 40, gen())
+            : make_field(8 + gen() % 90, 8 + gen() % 90, gen() % 40, gen() % 6, gen());
+        for (int q = 0; q < 25; q++, queries++) {
+            int start = random_open_node(map, gen), goal = random_open_node(map, gen);
+            float expected = reference_cost(map, start, goal);
+            float dijkstra = finder.dijkstra(map, start, goal, &path);
+            if (expected == pathfinder::NO_PATH) {
+                unreachable++;
+                assert(dijkstra == pathfinder::NO_PATH);
+                assert(finder.astar(map, start, goal, octile_heuristic(map)) == pathfinder::NO_PATH);
+                assert(finder.jps(map, start, goal) == pathfinder::NO_PATH);
+                continue;
+            }
+            assert(same_cost(dijkstra, expected) && same_cost(check_path(map, path, start, goal), expected));
+            assert(same_cost(finder.astar(map, start, goal, octile_heuristic(map), &path), expected));
+            assert(same_cost(check_path(map, path, start, goal), expected));
+            assert(same_cost(finder.astar(map, start, goal, euclidean_heuristic(map), &path), expected));
+            assert(same_cost(finder.jps(map, start, goal, &path), expected));
+            assert(same_cost(check_path(map, path, start, goal), expected));
+            // Inadmissible: a valid path, possibly longer
+            float manhattan = finder.astar(map, start, goal, manhattan_heuristic(map), &path);
+            assert(same_cost(check_path(map, path, start, goal), manhattan) && manhattan >= expected - 1e-3f);
+        }
+    }
+    printf("grids: %d queries (%d unreachable), all methods match the reference\n", queries, unreachable);
+
+    // General graphs: random geometric graph, A* with a straight line heuristic vs Dijkstra
+    {
+        const int N = 3000;
+        std::vector<float> px(N), py(N);
+        for (int i = 0; i < N; i++) {
+            px[i] = static_cast<float>(gen() % 10000);
+            py[i] = static_cast<float>(gen() % 10000);
+        }
+        std::vector<graph_edge> edges;
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < 4; k++) {
+                int j = gen() % N;
+                float length = std::sqrt((px[i] - px[j]) * (px[i] - px[j]) + (py[i] - py[j]) * (py[i] - py[j]));
+                float cost = length * (1.0f + static_cast<float>(gen() % 100) / 100.0f);
+                edges.push_back(graph_edge{ i, j, cost });
+                edges.push_back(graph_edge{ j, i, cost });
+            }
+        }
+        search_graph graph(N, edges);
+        auto straight_line = [&](int node, int goal) {
+            return std::sqrt((px[node] - px[goal]) * (px[node] - px[goal]) + (py[node] - py[goal]) * (py[node] - py[goal]));
+        };
+        size_t dijkstra_expanded = 0, astar_expanded = 0;
+        for (int q = 0; q < 200; q++) {
+            int start = gen() % N, goal = gen() % N;
+            float dijkstra = finder.dijkstra(graph, start, goal, &path);
+            dijkstra_expanded += finder.expanded();
+            if (dijkstra != pathfinder::NO_PATH) {
+                float sum = 0.0f;
+                for (size_t i = 1; i < path.size(); i++) {
+                    float best = FLT_MAX;
+                    for (const search_graph::Arc* arc = graph.begin(path[i - 1]); arc != graph.end(path[i - 1]); ++arc)
+                        if (arc->to == path[i] && arc->cost < best) best = arc->cost;
+                    assert(best != FLT_MAX);
+                    sum += best;
+                }
+                assert(same_cost(sum, dijkstra));
+            }
+            float astar = finder.astar(graph, start, goal, straight_line, &path);
+            astar_expanded += finder.expanded();
+            assert(same_cost(astar, dijkstra));
+        }
+        printf("graph: 200 queries on %d nodes, expanded Dijkstra %zu / A* %zu\n", N, dijkstra_expanded, astar_expanded);
+    }
+    printf("PASSED\n\n");
+}
+
+struct QueryBench {
+    double ms;
+    size_t expanded;
+    double cost_sum;
+};
+
+template<typename Query>
+static QueryBench bench_queries(const std::vector<std::pair<int, int>>& queries, Query query) {
+    QueryBench result = { 0.0, 0, 0.0 };
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& q : queries) {
+        size_t expanded = 0;
+        result.cost_sum += query(q.first, q.second, expanded);
+        result.expanded += expanded;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+static void print_bench(const char* name, const QueryBench& bench, size_t query_count) {
+    printf("  %-24s %9.1f ms | %6.0f us/query | %11zu expanded | %6.2f M expanded/s\n",
+        name, bench.ms, bench.ms * 1000.0 / query_count, bench.expanded, bench.expanded / bench.ms / 1000.0);
+}
+
+static void bench_map(const char* title, const grid_map& map, int query_count, unsigned int seed) {
+    std::mt19937 gen(seed);
+    pathfinder finder(map.node_count());
+    std::vector<std::pair<int, int>> queries;
+    while (static_cast<int>(queries.size()) < query_count) {
+        int start = random_open_node(map, gen), goal = random_open_node(map, gen);
+        if (finder.dijkstra(map, start, goal) != pathfinder::NO_PATH) queries.push_back(std::make_pair(start, goal));
+    }
+    printf("%s: %dx%d, %d queries\n", title, map.width(), map.height(), query_count);
+
+    QueryBench dijkstra = bench_queries(queries, [&](int s, int g, size_t& expanded) {
+        float cost = finder.dijkstra(map, s, g);
+        expanded = finder.expanded();
+        return cost;
+    });
+    QueryBench fresh = bench_queries(queries, [&](int s, int g, size_t& expanded) {
+        pathfinder once; // new open set and score arrays every query
+        float cost = once.dijkstra(map, s, g);
+        expanded = once.expanded();
+        return cost;
+    });
+    QueryBench astar = bench_queries(queries, [&](int s, int g, size_t& expanded) {
+        float cost = finder.astar(map, s, g, octile_heuristic(map));
+        expanded = finder.expanded();
+        return cost;
+    });
+    QueryBench manhattan = bench_queries(queries, [&](int s, int g, size_t& expanded) {
+        float cost = finder.astar(map, s, g, manhattan_heuristic(map));
+        expanded = finder.expanded();
+        return cost;
+    });
+    QueryBench jps = bench_queries(queries, [&](int s, int g, size_t& expanded) {
+        float cost = finder.jps(map, s, g);
+        expanded = finder.expanded();
+        return cost;
+    });
+    assert(same_cost(static_cast<float>(astar.cost_sum), static_cast<float>(dijkstra.cost_sum)));
+    assert(same_cost(static_cast<float>(jps.cost_sum), static_cast<float>(dijkstra.cost_sum)));
+    print_bench("Dijkstra (reused state)", dijkstra, queries.size());
+    print_bench("Dijkstra (fresh state)", fresh, queries.size());
+    print_bench("A* octile", astar, queries.size());
+    print_bench("A* manhattan", manhattan, queries.size());
+    print_bench("JPS", jps, queries.size());
+    printf("  manhattan path length +%.2f%% over optimal\n", (manhattan.cost_sum / dijkstra.cost_sum - 1.0) * 100.0);
+}
+
+static void test_pathfinder_performance() {
+    printf("=== pathfinder benchmark ===\n");
+    bench_map("maze", make_maze(511, 511, 2000, 11), 40, 1);
+    bench_map("scattered rocks", make_field(1024, 1024, 10, 0, 12), 40, 2);
+    bench_map("city blocks", make_field(1024, 1024, 0, 200, 13), 40, 3);
+    printf("\n");
+}
+
+void test_pathfinder() {
+    test_pathfinder_correctness();
+    test_pathfinder_performance();
+}
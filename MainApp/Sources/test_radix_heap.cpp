@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "indexed_heap.h"
+#include "radix_heap.h"
+
+static void test_radix_heap_correctness() {
+    printf("=== radix_heap correctness ===\n");
+    radix_heap<uint32_t> heap;
+    assert(heap.empty() && heap.pop() == -1);
+
+    // Against indexed_heap on a monotone workload: every push / decrease_key stays >= last()
+    const int N = 5000;
+    std::mt19937 gen(17);
+    indexed_heap<uint32_t> reference(N);
+    for (int op = 0; op < 300000; op++) {
+        int id = gen() % N;
+        uint32_t priority = heap.last() + gen() % (1u << (gen() % 24));
+        switch (gen() % 4) {
+        case 0:
+        case 1:
+            heap.push(id, priority);
+            reference.push(id, priority);
+            break;
+        case 2:
+            heap.decrease_key(id, priority);
+            reference.decrease_key(id, priority);
+            break;
+        default: {
+            int id_a = -1, id_b = -1;
+            uint32_t key_a = 0, key_b = 0;
+            bool popped = heap.pop(id_a, key_a);
+            assert(popped == reference.pop(id_b, key_b));
+            assert(!popped || key_a == key_b);
+            if (popped && id_a != id_b) {
+                // Equal keys may pop in a different order; swap the ids back so both heaps hold the same set
+                assert(reference.get_priority(id_a) == key_a);
+                reference.erase(id_a);
+                reference.push(id_b, key_b);
+            }
+        }
+        }
+        assert(heap.size() == reference.size());
+    }
+    uint32_t last = 0;
+    int id = -1;
+    uint32_t key = 0;
+    while (heap.pop(id, key)) {
+        assert(key >= last && reference.contains(id) && reference.get_priority(id) == key);
+        last = key;
+    }
+
+    // 64 bit keys, erase, and a push below last() raised to last()
+    radix_heap<uint64_t> wide;
+    wide.push(1, 1ull << 40);
+    wide.push(2, 5);
+    wide.push(3, (1ull << 40) + 1);
+    assert(wide.erase(3) && !wide.erase(3));
+    assert(wide.pop() == 2 && wide.last() == 5);
+    wide.push(4, 0);
+    assert(wide.get_priority(4) == 5 && wide.pop() == 4);
+    assert(wide.pop() == 1 && wide.last() == (1ull << 40) && wide.empty());
+    assert(wide.get_priority(1) == 0 && wide.get_priority(3) == 0 && wide.get_priority(-1) == 0 && wide.get_priority(100) == 0);
+    printf("PASSED\n\n");
+}
+
+// Dijkstra over a grid with integer edge costs: the monotone case both heaps support
+template<typename Heap>
+static long long run_grid_dijkstra(Heap& heap, const std::vector<uint32_t>& cost, int width, int height, uint32_t& goal_dist) {
+    std::vector<uint32_t> dist(cost.size(), UINT32_MAX);
+    auto start = std::chrono::high_resolution_clock::now();
+    dist[0] = 0;
+    heap.push(0, 0u);
+    const int dx[] = { 1, -1, 0, 0 };
+    const int dy[] = { 0, 0, 1, -1 };
+    while (!heap.empty()) {
+        int u = heap.pop();
+        int ux = u % width, uy = u / width;
+        for (int d = 0; d < 4; d++) {
+            int nx = ux + dx[d], ny = uy + dy[d];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+            int v = ny * width + nx;
+            uint32_t nd = dist[u] + cost[v];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                heap.push(v, nd);
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    goal_dist = dist[cost.size() - 1];
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static void test_radix_heap_performance() {
+    printf("=== radix_heap vs indexed_heap ===\n");
+    const int width = 1000, height = 1000;
+    std::mt19937 gen(23);
+    std::vector<uint32_t> cost(width * height);
+    for (uint32_t& c : cost) c = 1 + gen() % 100;
+
+    uint32_t radix_goal = 0, indexed_goal = 0;
+    radix_heap<uint32_t> radix(width * height);
+    indexed_heap<uint32_t> indexed(width * height);
+    long long radix_time = run_grid_dijkstra(radix, cost, width, height, radix_goal);
+    long long indexed_time = run_grid_dijkstra(indexed, cost, width, height, indexed_goal);
+    assert(radix_goal == indexed_goal);
+    printf("grid dijkstra 1000x1000  radix_heap: %lld us, indexed_heap: %lld us\n", radix_time, indexed_time);
+
+    // Timer pattern: 1M deadlines, pop one and re-arm it further in the future
+    const int N = 1000000;
+    std::vector<uint32_t> deadline(N);
+    for (uint32_t& d : deadline) d = gen() % 60000;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        radix_heap<uint32_t> timers(N);
+        for (int i = 0; i < N; i++) timers.push(i, deadline[i]);
+        for (int i = 0; i < 2 * N; i++) {
+            int id = 0;
+            uint32_t now = 0;
+            timers.pop(id, now);
+            timers.push(id, now + 1 + deadline[id] % 30000);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    radix_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        indexed_heap<uint32_t> timers(N);
+        for (int i = 0; i < N; i++) timers.push(i, deadline[i]);
+        for (int i = 0; i < 2 * N; i++) {
+            int id = 0;
+            uint32_t now = 0;
+            timers.pop(id, now);
+            timers.push(id, now + 1 + deadline[id] % 30000);
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    indexed_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    printf("timer re-arm 1M x2  radix_heap: %lld us, indexed_heap: %lld us\n", radix_time, indexed_time);
+    printf("PASSED\n\n");
+}
+
+void test_radix_heap() {
+    test_radix_heap_correctness();
+    test_radix_heap_performance();
+}
@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "indexed_heap.h"
+#include "timing_wheel.h"
+#include <map>
+
+static void test_timing_wheel_correctness() {
+    printf("=== timing_wheel correctness ===\n");
+    const int N = 3000;
+    std::mt19937_64 gen(31);
+    timing_wheel wheel(1000);
+    std::map<int, uint64_t> deadline_of;
+    std::multimap<uint64_t, int> by_deadline;
+    std::vector<int> expired;
+
+    auto forget = [&](int id) {
+        auto it = deadline_of.find(id);
+        if (it == deadline_of.end()) return;
+        auto range = by_deadline.equal_range(it->second);
+        for (auto r = range.first; r != range.second; ++r) {
+            if (r->second == id) { by_deadline.erase(r); break; }
+        }
+        deadline_of.erase(it);
+    };
+
+    for (int op = 0; op < 300000; op++) {
+        int id = static_cast<int>(gen() % N);
+        uint64_t now = wheel.now();
+        switch (gen() % 8) {
+        case 0: case 1: case 2: {
+            // Mostly near deadlines, some a few levels out, a few past the 2^32 tick range, some already due
+            uint64_t delta;
+            switch (gen() % 6) {
+            case 0: delta = gen() % 300; break;
+            case 1: delta = gen() % 100000; break;
+            case 2: delta = gen() % (1ULL << 30); break;
+            case 3: delta = gen() % (1ULL << 36); break;
+            default: delta = gen() % 5000; break;
+            }
+            uint64_t deadline = (gen() % 20 == 0) ? now - (gen() % 50) : now + delta;
+            wheel.schedule(id, deadline);
+            forget(id);
+            deadline_of[id] = deadline;
+            by_deadline.insert(std::make_pair(deadline, id));
+            break;
+        }
+        case 3:
+            assert(wheel.cancel(id) == (deadline_of.count(id) == 1));
+            forget(id);
+            break;
+        default: {
+            uint64_t step;
+            switch (gen() % 10) {
+            case 0: step = gen() % (1ULL << 34); break;
+            case 1: step = gen() % 70000; break;
+            default: step = gen() % 400; break;
+            }
+            expired.clear();
+            size_t count = wheel.advance(now + step, expired);
+            assert(count == expired.size() && wheel.now() == now + step);
+
+            std::vector<int> expected;
+            while (!by_deadline.empty() && by_deadline.begin()->first <= now + step) {
+                expected.push_back(by_deadline.begin()->second);
+                deadline_of.erase(by_deadline.begin()->second);
+                by_deadline.erase(by_deadline.begin());
+            }
+            std::sort(expected.begin(), expected.end());
+            std::sort(expired.begin(), expired.end());
+            assert(expected == expired);
+        }
+        }
+        assert(wheel.size() == deadline_of.size());
+    }
+
+    // Reschedule moves a timer, cancel removes it, expiry follows deadline order
+    timing_wheel small;
+    small.schedule(1, 500);
+    small.schedule(2, 100);
+    small.schedule(3, 70000);
+    small.schedule(2, 600);
+    assert(small.cancel(1) && !small.cancel(1));
+    expired.clear();
+    small.advance(599, expired);
+    assert(expired.empty());
+    small.advance(80000, expired);
+    assert(expired.size() == 2 && expired[0] == 2 && expired[1] == 3 && small.empty());
+    printf("PASSED\n\n");
+}
+
+static void test_timing_wheel_performance() {
+    printf("=== timing_wheel vs indexed_heap (session timeouts) ===\n");
+    // 200k sessions with a 10s idle timeout on a 1ms tick. Every tick, 100 sessions see traffic and
+    // push their timeout back (80% of it from the busiest 20% of sessions), 5 disconnect (cancel)
+    // and 5 connect; quiet sessions expire.
+    const int SESSIONS = 200000;
+    const int TICKS = 20000;
+    const uint64_t TIMEOUT = 10000;
+    std::mt19937 gen(41);
+    std::vector<int> active(TICKS * 100), leaving(TICKS * 5), joining(TICKS * 5);
+    std::vector<uint64_t> jitter(SESSIONS);
+    for (int& id : active) id = (gen() % 5 != 0) ? gen() % (SESSIONS / 5) : gen() % SESSIONS;
+    for (int& id : leaving) id = gen() % SESSIONS;
+    for (int& id : joining) id = gen() % SESSIONS;
+    for (uint64_t& j : jitter) j = gen() % 5000;
+
+    size_t wheel_expired = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        timing_wheel wheel(0, SESSIONS);
+        std::vector<int> expired;
+        for (int id = 0; id < SESSIONS; id++) wheel.schedule(id, TIMEOUT + jitter[id]);
+        for (uint64_t now = 1; now <= TICKS; now++) {
+            for (int i = 0; i < 100; i++) {
+                int id = active[(now - 1) * 100 + i];
+                wheel.schedule(id, now + TIMEOUT + jitter[id]);
+            }
+            for (int i = 0; i < 5; i++) {
+                wheel.cancel(leaving[(now - 1) * 5 + i]);
+                int id = joining[(now - 1) * 5 + i];
+                wheel.schedule(id, now + TIMEOUT + jitter[id]);
+            }
+            expired.clear();
+            wheel_expired += wheel.advance(now, expired);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    long long wheel_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    size_t heap_expired = 0;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        indexed_heap<uint64_t> heap(SESSIONS);
+        for (int id = 0; id < SESSIONS; id++) heap.push(id, TIMEOUT + jitter[id]);
+        for (uint64_t now = 1; now <= TICKS; now++) {
+            for (int i = 0; i < 100; i++) {
+                int id = active[(now - 1) * 100 + i];
+                heap.update(id, now + TIMEOUT + jitter[id]);
+            }
+            for (int i = 0; i < 5; i++) {
+                heap.erase(leaving[(now - 1) * 5 + i]);
+                int id = joining[(now - 1) * 5 + i];
+                heap.update(id, now + TIMEOUT + jitter[id]);
+            }
+            while (!heap.empty() && heap.top_priority() <= now) {
+                heap.pop();
+                ++heap_expired;
+            }
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    long long heap_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    assert(wheel_expired == heap_expired);
+    printf("%d ticks, %zu expired  timing_wheel: %lld us, indexed_heap: %lld us\n",
+        TICKS, wheel_expired, wheel_time, heap_time);
+    printf("PASSED\n\n");
+}
+
+void test_timing_wheel() {
+    test_timing_wheel_correctness();
+    test_timing_wheel_performance();
+}